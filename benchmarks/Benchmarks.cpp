@@ -0,0 +1,327 @@
+/*
+ * Copyright (c) 2006 Emir UNER
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+//
+// Timings of the parts that do not need a display: the segment sweep
+// against testing every pair, loading binary against text polyline files,
+// color parsing and formatting, and window callback dispatch through the
+// headless GLUT functions of HeadlessGlut.cpp. Build with optimization,
+// for example CMAKE_BUILD_TYPE=Release, for meaningful numbers.
+//
+
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <vector>
+
+#include <simge/algo/SegmentIntersections.hpp>
+#include <simge/glut/Window.hpp>
+#include <simge/util/BinaryPolylineFile.hpp>
+#include <simge/util/Color.hpp>
+#include <simge/util/MappedPolylineFile.hpp>
+#include <simge/util/PolylineWriter.hpp>
+
+#include "HeadlessGlut.hpp"
+
+using namespace simge;
+using namespace simge::geom;
+
+namespace
+{
+    typedef std::chrono::steady_clock Clock;
+
+    double secondsSince(Clock::time_point start)
+    {
+        return std::chrono::duration<double>(Clock::now() - start).count();
+    }
+
+    void report(char const* name, double seconds, double operations)
+    {
+        std::printf("%-40s %10.3f ms %12.1f ns/op\n", name, seconds * 1e3, seconds * 1e9 / operations);
+    }
+
+    /**
+     * Same sequence on every platform, unlike rand().
+     */
+    class Random
+    {
+    public:
+        explicit Random(unsigned long long seed)
+        : state_(seed)
+        {
+        }
+
+        // Uniform in [0, 1)
+        double next()
+        {
+            state_ = state_ * 6364136223846793005ULL + 1442695040888963407ULL;
+
+            return static_cast<double>(state_ >> 11) / 9007199254740992.0;
+        }
+
+    private:
+        unsigned long long state_;
+    };
+
+    class CountingListener : public algo::IntersectionListener
+    {
+    public:
+        CountingListener()
+        : count(0)
+        {
+        }
+
+        void found(int, int, Point<2> const&)
+        {
+            ++count;
+        }
+
+        long long count;
+    };
+
+    /**
+     * Short segments scattered over the unit square, so that the count of
+     * intersections grows about linearly with the count of segments.
+     */
+    std::vector<Edge<2> > randomSegments(int count, Random& random)
+    {
+        std::vector<Edge<2> > edges;
+        const double length = 4.0 / count;
+
+        for(int i = 0; i < count; ++i)
+        {
+            const double x = random.next();
+            const double y = random.next();
+
+            edges.push_back(Edge<2>(point(x, y), point(x + length * (random.next() - 0.5) * 64,
+                                                      y + length * (random.next() - 0.5) * 64)));
+        }
+
+        return edges;
+    }
+
+    /**
+     * Testing all pairs takes quadratic time, so it is only timed for
+     * small counts.
+     */
+    void benchmarkIntersections(int count, bool allPairs)
+    {
+        Random random(count);
+        const std::vector<Edge<2> > edges = randomSegments(count, random);
+        CountingListener sweep;
+        char name[64];
+
+        Clock::time_point start = Clock::now();
+        algo::findAllIntersections(edges, sweep);
+        std::snprintf(name, sizeof(name), "sweep %d segments", count);
+        report(name, secondsSince(start), count);
+
+        if(!allPairs)
+        {
+            return;
+        }
+
+        long long brute = 0;
+        Point<2> at;
+
+        start = Clock::now();
+
+        for(int i = 0; i < count; ++i)
+        {
+            for(int j = i + 1; j < count; ++j)
+            {
+                brute += intersection(edges[i], edges[j], at);
+            }
+        }
+
+        std::snprintf(name, sizeof(name), "all pairs %d segments", count);
+        report(name, secondsSince(start), count);
+        std::printf("%-40s %lld / %lld\n", "  intersections sweep / all pairs", sweep.count, brute);
+    }
+
+    void benchmarkLoading(int polylineCount, int pointsPerPolyline)
+    {
+        typedef Point<2> PointType;
+
+        const char* const textPath = "simge-benchmark.txt";
+        const char* const binaryPath = "simge-benchmark.bin";
+        Random random(polylineCount);
+        util::Polyline<PointType> line;
+
+        {
+            std::ofstream text(textPath, std::ios::binary);
+            util::PolylineWriter<PointType> textWriter(text, polylineCount);
+            util::BinaryPolylineWriter binaryWriter(binaryPath, 2);
+
+            for(int i = 0; i < polylineCount; ++i)
+            {
+                line.points.clear();
+
+                for(int j = 0; j < pointsPerPolyline; ++j)
+                {
+                    line.points.push_back(point(random.next() * 1000, random.next() * 1000));
+                }
+
+                textWriter.write(line);
+                binaryWriter.write(line);
+            }
+
+            textWriter.close();
+            binaryWriter.close();
+        }
+
+        const double points = static_cast<double>(polylineCount) * pointsPerPolyline;
+        double sum = 0;
+
+        Clock::time_point start = Clock::now();
+        {
+            util::MappedPolylineFile<PointType> in(textPath);
+            util::PolylineArena<PointType> arena;
+
+            in.readAll(arena);
+
+            for(std::size_t i = 0; i < arena.points.size(); ++i)
+            {
+                sum += arena.points[i][0];
+            }
+        }
+        report("text load, per point", secondsSince(start), points);
+
+        start = Clock::now();
+        {
+            util::BinaryPolylineFile in(binaryPath);
+
+            for(int i = 0; i < in.getPolylineCount(); ++i)
+            {
+                util::PolylineSpan<PointType> span = in.get<PointType>(i);
+
+                for(std::size_t j = 0; j < span.count; ++j)
+                {
+                    sum -= span.points[j][0];
+                }
+            }
+        }
+        report("binary load, per point", secondsSince(start), points);
+        std::printf("%-40s %g\n", "  coordinate sum difference from rounding", sum);
+
+        std::remove(textPath);
+        std::remove(binaryPath);
+    }
+
+    void benchmarkColors(int count)
+    {
+        static char const* const texts[] = { "#f00", "#12ab34", "#0123456789ab", "#fff", "#a0b0c0" };
+        const int textCount = sizeof(texts) / sizeof(texts[0]);
+        int lengths[textCount];
+        util::Color color;
+        char out[util::kMaxColorChars];
+        long long checksum = 0;
+
+        for(int i = 0; i < textCount; ++i)
+        {
+            lengths[i] = std::char_traits<char>::length(texts[i]);
+        }
+
+        Clock::time_point start = Clock::now();
+
+        for(int i = 0; i < count; ++i)
+        {
+            checksum += util::parseColor(texts[i % textCount], lengths[i % textCount], color);
+            checksum += color.g;
+        }
+
+        report("color parse", secondsSince(start), count);
+        start = Clock::now();
+
+        for(int i = 0; i < count; ++i)
+        {
+            color.r = i & 0xffff;
+            checksum += util::formatColor(out, color) - out;
+        }
+
+        report("color format", secondsSince(start), count);
+        std::printf("%-40s %lld\n", "  checksum", checksum);
+    }
+
+    class CountingWindow : public glut::Window
+    {
+    public:
+        CountingWindow()
+        : glut::Window("benchmark"), clicks(0)
+        {
+        }
+
+        long long clicks;
+
+    protected:
+        void mouseGL(int, int, int, int)
+        {
+            ++clicks;
+        }
+    };
+
+    void benchmarkWindowDispatch(int windowCount, int count)
+    {
+        std::vector<CountingWindow*> windows;
+
+        for(int i = 0; i < windowCount; ++i)
+        {
+            windows.push_back(new CountingWindow());
+        }
+
+        Clock::time_point start = Clock::now();
+
+        for(int i = 0; i < count; ++i)
+        {
+            // Window ids start at 1
+            headlessSetWindow(1 + i % windowCount);
+            headlessMouse(0, 0, i, i);
+        }
+
+        char name[64];
+
+        std::snprintf(name, sizeof(name), "mouse dispatch over %d windows", windowCount);
+        report(name, secondsSince(start), count);
+
+        for(int i = 0; i < windowCount; ++i)
+        {
+            if(windows[i]->clicks != count / windowCount + (i < count % windowCount))
+            {
+                std::printf("  window %d got %lld clicks\n", i + 1, windows[i]->clicks);
+            }
+
+            delete windows[i];
+        }
+    }
+}
+
+int main()
+{
+    benchmarkIntersections(2000, true);
+    benchmarkIntersections(8000, true);
+    benchmarkIntersections(100000, false);
+    benchmarkLoading(20000, 50);
+    benchmarkColors(1000000);
+    benchmarkWindowDispatch(16, 10000000);
+
+    return 0;
+}
@@ -0,0 +1,114 @@
+/*
+ * Copyright (c) 2006 Emir UNER
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+//
+// The GLUT functions used by glut::Window, replaced so that windows can be
+// created and their callbacks dispatched without a display. Windows get
+// increasing ids and the callbacks of the last created window are kept.
+//
+
+#include <GL/glut.h>
+
+#include "HeadlessGlut.hpp"
+
+namespace
+{
+    int lastId = 0;
+    int currentId = 0;
+    void (*mouseCallback)(int, int, int, int) = 0;
+}
+
+void headlessSetWindow(int id)
+{
+    currentId = id;
+}
+
+void headlessMouse(int button, int state, int x, int y)
+{
+    mouseCallback(button, state, x, y);
+}
+
+extern "C"
+{
+    void glutInitDisplayMode(unsigned int)
+    {
+    }
+
+    int glutCreateWindow(char const*)
+    {
+        currentId = ++lastId;
+
+        return currentId;
+    }
+
+    int glutGetWindow()
+    {
+        return currentId;
+    }
+
+    void glutSetWindow(int id)
+    {
+        currentId = id;
+    }
+
+    void glutMouseFunc(void (*callback)(int, int, int, int))
+    {
+        mouseCallback = callback;
+    }
+
+    void glutDisplayFunc(void (*)())
+    {
+    }
+
+    void glutReshapeFunc(void (*)(int, int))
+    {
+    }
+
+    void glutMotionFunc(void (*)(int, int))
+    {
+    }
+
+    void glutPassiveMotionFunc(void (*)(int, int))
+    {
+    }
+
+    void glutKeyboardFunc(void (*)(unsigned char, int, int))
+    {
+    }
+
+    void glutPostRedisplay()
+    {
+    }
+
+    int glutGet(GLenum)
+    {
+        return 0;
+    }
+
+    void glutReshapeWindow(int, int)
+    {
+    }
+
+    void glutSwapBuffers()
+    {
+    }
+}
@@ -0,0 +1,61 @@
+/*
+ * Copyright (c) 2006 Emir UNER
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef SIMGE_ALGO_SEGMENTINTERSECTIONS_HPP_INCLUDED
+#define SIMGE_ALGO_SEGMENTINTERSECTIONS_HPP_INCLUDED
+
+#include <vector>
+#include <simge/geom/Edge.hpp>
+
+namespace simge { namespace algo {
+
+/**
+ * Receives the intersections found by findAllIntersections.
+ */
+class IntersectionListener
+{
+public:
+    /**
+     * Called once for every pair of edges that have at least one common
+     * point. first and second are indexes into the edge vector with
+     * first < second. For edges that overlap, at is the first common
+     * point in sweep order.
+     */
+    virtual void found(int first, int second, geom::Point<2> const& at) = 0;
+
+    virtual inline ~IntersectionListener()
+    {
+    }
+};
+
+/**
+ * Finds all pairs of intersecting edges with a Bentley-Ottmann sweep in
+ * O((n + k) log n) time where k is the number of intersecting pairs.
+ * Edges touching at an end point, edges sharing an end point and
+ * collinear overlapping edges are all reported. Points closer than
+ * 1e-8 are considered to be the same, as with Point's operator==.
+ */
+void findAllIntersections(std::vector<geom::Edge<2> > const& edges, IntersectionListener& listener);
+
+} } // namespace algo / simge
+
+#endif
@@ -0,0 +1,108 @@
+/*
+ * Copyright (c) 2006 Emir UNER
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef SIMGE_ALGO_SIMPLIFY_HPP_INCLUDED
+#define SIMGE_ALGO_SIMPLIFY_HPP_INCLUDED
+
+#include <vector>
+#include <simge/geom/Point.hpp>
+
+//
+// Polyline simplification by vertex importance. Every vertex gets a
+// number, and the vertexes whose number is at least a threshold form the
+// simplified polyline. Thresholds nest: raising the threshold only drops
+// vertexes. The end points are always kept.
+//
+// For Douglas-Peucker the importance is a distance and for Visvalingam an
+// area, so for a view showing scale pixels per unit and a tolerance of
+// p pixels the threshold is p / scale and (p / scale)^2 respectively.
+//
+
+namespace simge { namespace algo {
+
+/**
+ * Douglas-Peucker importance: the largest tolerance at which the vertex
+ * is still kept.
+ */
+void douglasPeuckerImportance(std::vector<geom::Point<2> > const& points, std::vector<double>& importance);
+
+/**
+ * Visvalingam-Whyatt importance: the effective area of the vertex when
+ * the vertexes are removed in the order of the smallest area.
+ */
+void visvalingamImportance(std::vector<geom::Point<2> > const& points, std::vector<double>& importance);
+
+/**
+ * Appends the indexes of the vertexes kept by Douglas-Peucker with the
+ * given tolerance to kept, in increasing order.
+ */
+void douglasPeucker(std::vector<geom::Point<2> > const& points, double tolerance, std::vector<int>& kept);
+
+/**
+ * Appends the indexes of the vertexes kept by Visvalingam-Whyatt with the
+ * given minimum area to kept, in increasing order.
+ */
+void visvalingam(std::vector<geom::Point<2> > const& points, double minArea, std::vector<int>& kept);
+
+/**
+ * Selects the vertexes with an importance at least a threshold in time
+ * proportional to their count. The importance values are stored in a
+ * Cartesian tree: a binary tree that is ordered by index and in which
+ * every vertex is at least as important as the vertexes below it, so the
+ * search stops at the first vertex under the threshold.
+ */
+class SimplificationPyramid
+{
+public:
+    SimplificationPyramid();
+
+    /**
+     * Builds the tree in linear time.
+     */
+    explicit SimplificationPyramid(std::vector<double> const& importance);
+
+    /**
+     * Appends the indexes with an importance at least threshold to kept,
+     * in increasing order.
+     */
+    void select(double threshold, std::vector<int>& kept) const;
+
+    int size() const
+    {
+        return importance_.size();
+    }
+
+    double getImportance(int i) const
+    {
+        return importance_[i];
+    }
+
+private:
+    std::vector<double> importance_;
+    std::vector<int> left_;
+    std::vector<int> right_;
+    int root_;
+};
+
+} } // namespace algo / simge
+
+#endif
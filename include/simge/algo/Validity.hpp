@@ -0,0 +1,101 @@
+/*
+ * Copyright (c) 2006 Emir UNER
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef SIMGE_ALGO_VALIDITY_HPP_INCLUDED
+#define SIMGE_ALGO_VALIDITY_HPP_INCLUDED
+
+#include <vector>
+#include <utility>
+#include <simge/geom/Polygon.hpp>
+
+namespace simge { namespace algo {
+
+/**
+ * Problems found in a polygon by validatePolygon.
+ * Edge i goes from vertex i to vertex i + 1, the last edge closes the polygon.
+ */
+struct PolygonDefects
+{
+    /**
+     * Pairs of edges that intersect other than the neighbouring edges
+     * meeting at their common vertex. Neighbouring edges that fold back
+     * onto each other are included. first < second.
+     */
+    std::vector<std::pair<int, int> > crossings;
+
+    /**
+     * Indexes of the vertexes equal to a vertex with a smaller index.
+     * Coordinates are compared exactly, without the tolerance of Point's
+     * operator==. Use Polygon::normalize first to merge nearly equal
+     * vertexes.
+     */
+    std::vector<int> duplicates;
+
+    /**
+     * The vertexes do not go around in the direction the polygon type
+     * requires: counter-clockwise for left is interior polygons, clockwise
+     * for right is interior polygons. Polygons with zero area are always
+     * wrongly oriented.
+     */
+    bool wrongOrientation;
+
+    /**
+     * The polygon is not monotone with respect to the x axis,
+     * as triangulateMonotone requires.
+     */
+    bool notMonotone;
+
+    PolygonDefects()
+    : wrongOrientation(false), notMonotone(false)
+    {
+    }
+
+    /**
+     * True if the polygon has no crossing edges and no duplicate vertexes.
+     */
+    bool isSimple() const
+    {
+        return crossings.empty() && duplicates.empty();
+    }
+
+    /**
+     * True if the polygon is simple and correctly oriented.
+     */
+    bool isValid() const
+    {
+        return isSimple() && !wrongOrientation;
+    }
+};
+
+/**
+ * Checks the polygon in O(n log n) time using a sweep for crossing edges.
+ */
+PolygonDefects validatePolygon(geom::Polygon<2> const& poly);
+
+/**
+ * Checks whether the polygon is monotone with respect to the x axis in O(n) time.
+ */
+bool isMonotone(geom::Polygon<2> const& poly);
+
+} } // namespace algo / simge
+
+#endif
@@ -0,0 +1,177 @@
+/*
+ * Copyright (c) 2006 Emir UNER
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef SIMGE_GEOM_BOX_HPP_INCLUDED
+#define SIMGE_GEOM_BOX_HPP_INCLUDED
+
+#include <math.h>
+#include <ostream>
+
+#include <simge/geom/Point.hpp>
+
+namespace simge { namespace geom
+{
+
+/**
+ * An axis aligned box in Dim-dimensional space.
+ * A default constructed box is empty, extending it with a point
+ * makes it the box containing only that point.
+ */
+template <int Dim>
+class Box
+{
+public:
+    Box()
+    {
+        for(int i = 0; i < Dim; ++i)
+        {
+            min_[i] = HUGE_VAL;
+            max_[i] = -HUGE_VAL;
+        }
+    }
+
+    Box(Point<Dim> const& min, Point<Dim> const& max)
+    : min_(min), max_(max)
+    {
+    }
+
+    Point<Dim> const& getMin() const
+    {
+        return min_;
+    }
+
+    Point<Dim> const& getMax() const
+    {
+        return max_;
+    }
+
+    /**
+     * True if no point has been added to this box.
+     */
+    bool isEmpty() const
+    {
+        return min_[0] > max_[0];
+    }
+
+    /**
+     * Length of the box along the given axis.
+     */
+    double extent(int axis) const
+    {
+        return isEmpty() ? 0 : max_[axis] - min_[axis];
+    }
+
+    Point<Dim> center() const
+    {
+        return findMidPoint(min_, max_);
+    }
+
+    /**
+     * Grow the box so that it contains the given point.
+     */
+    void extend(Point<Dim> const& p)
+    {
+        for(int i = 0; i < Dim; ++i)
+        {
+            if(p[i] < min_[i])
+            {
+                min_[i] = p[i];
+            }
+
+            if(p[i] > max_[i])
+            {
+                max_[i] = p[i];
+            }
+        }
+    }
+
+    /**
+     * Grow the box so that it contains the given box.
+     */
+    void extend(Box<Dim> const& other)
+    {
+        if(!other.isEmpty())
+        {
+            extend(other.min_);
+            extend(other.max_);
+        }
+    }
+
+    bool contains(Point<Dim> const& p) const
+    {
+        for(int i = 0; i < Dim; ++i)
+        {
+            if(p[i] < min_[i] || p[i] > max_[i])
+            {
+                return false;
+            }
+        }
+
+        return true;
+    }
+
+    bool contains(Box<Dim> const& other) const
+    {
+        return !other.isEmpty() && contains(other.min_) && contains(other.max_);
+    }
+
+    /**
+     * True if the boxes share at least one point. Touching boxes intersect.
+     */
+    bool intersects(Box<Dim> const& other) const
+    {
+        for(int i = 0; i < Dim; ++i)
+        {
+            if(other.max_[i] < min_[i] || other.min_[i] > max_[i])
+            {
+                return false;
+            }
+        }
+
+        return true;
+    }
+
+private:
+    Point<Dim> min_;
+    Point<Dim> max_;
+};
+
+template <int Dim>
+inline Box<Dim> box(Point<Dim> const& p0, Point<Dim> const& p1)
+{
+    Box<Dim> result;
+
+    result.extend(p0);
+    result.extend(p1);
+
+    return result;
+}
+
+template <int Dim>
+std::ostream& operator<<(std::ostream& os, Box<Dim> const& b)
+{
+    return os << "box[" << b.getMin() << ", " << b.getMax() << ']';
+}
+
+} } // namespace geom/simge
+
+#endif
@@ -0,0 +1,504 @@
+/*
+ * Copyright (c) 2006 Emir UNER
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef SIMGE_GEOM_LOOSEQUADTREE_HPP_INCLUDED
+#define SIMGE_GEOM_LOOSEQUADTREE_HPP_INCLUDED
+
+#include <vector>
+#include <stdexcept>
+
+#include <simge/geom/Box.hpp>
+
+namespace simge { namespace geom
+{
+
+/**
+ * A loose quadtree for objects that move frequently.
+ *
+ * Every node's bounds are its quadtree cell grown by half a cell on each
+ * side. An object is stored in the deepest node whose cell is at least as
+ * large as the object and which contains the object's center, so it always
+ * fits in that node's loose bounds. As long as a moved object still fits
+ * in the loose bounds of its node the move only updates the stored box.
+ *
+ * Nodes and objects are kept in pools and reused, nothing is allocated
+ * once the pools are warmed up. Objects are identified by the int returned
+ * from insert(). Objects whose center is outside of the world box are kept
+ * at the root node.
+ */
+class LooseQuadtree
+{
+public:
+    /**
+     * A relocation request for the batched version of move().
+     */
+    struct Move
+    {
+        int id;
+        Box<2> box;
+
+        Move()
+        {
+        }
+
+        Move(int nid, Box<2> const& nbox)
+        : id(nid), box(nbox)
+        {
+        }
+    };
+
+    /**
+     * A tree covering world. maxDepth is clamped to [0, 16].
+     */
+    LooseQuadtree(Box<2> const& world, int maxDepth = 8)
+    : maxDepth_(maxDepth), freeNode_(-1), freeEntry_(-1), size_(0)
+    {
+        if(maxDepth_ < 0)
+        {
+            maxDepth_ = 0;
+        }
+
+        if(maxDepth_ > kMaxDepth)
+        {
+            maxDepth_ = kMaxDepth;
+        }
+
+        if(world.isEmpty())
+        {
+            throw std::invalid_argument("loose quadtree world box is empty");
+        }
+
+        root_ = allocateNode(-1, world);
+    }
+
+    /**
+     * Add an object with the given bounds. Returns its id.
+     */
+    int insert(Box<2> const& box)
+    {
+        const int id = allocateEntry();
+
+        entries_[id].box = box;
+        link(id, findNode(box));
+        ++size_;
+
+        return id;
+    }
+
+    /**
+     * Remove the object with the given id. The id may be reused by
+     * a later insert().
+     */
+    void remove(int id)
+    {
+        const int node = entries_[id].node;
+
+        unlink(id);
+        releaseEntry(id);
+        --size_;
+        prune(node);
+    }
+
+    /**
+     * Change the bounds of the object with the given id.
+     */
+    void move(int id, Box<2> const& box)
+    {
+        const int node = relocate(id, box);
+
+        if(node != -1)
+        {
+            prune(node);
+        }
+    }
+
+    /**
+     * Apply many moves at once. Nodes emptied by the moves are
+     * released once at the end instead of after every move.
+     */
+    void move(std::vector<Move> const& moves)
+    {
+        vacated_.clear();
+
+        for(std::vector<Move>::const_iterator it = moves.begin(); it != moves.end(); ++it)
+        {
+            const int node = relocate(it->id, it->box);
+
+            if(node != -1)
+            {
+                vacated_.push_back(node);
+            }
+        }
+
+        for(std::vector<int>::const_iterator it = vacated_.begin(); it != vacated_.end(); ++it)
+        {
+            prune(*it);
+        }
+    }
+
+    /**
+     * Bounds of the object with the given id.
+     */
+    Box<2> const& getBox(int id) const
+    {
+        return entries_[id].box;
+    }
+
+    /**
+     * Depth of the node holding the object with the given id,
+     * 0 for the root.
+     */
+    int getDepth(int id) const
+    {
+        return nodes_[entries_[id].node].depth;
+    }
+
+    /**
+     * Count of the objects in the tree.
+     */
+    int size() const
+    {
+        return size_;
+    }
+
+    /**
+     * Removes all objects. Keeps the pools.
+     */
+    void clear()
+    {
+        const Box<2> world = nodes_[root_].cell;
+
+        nodes_.clear();
+        entries_.clear();
+        freeNode_ = -1;
+        freeEntry_ = -1;
+        size_ = 0;
+        root_ = allocateNode(-1, world);
+    }
+
+    /**
+     * Fills the given collection with the ids of the objects
+     * intersecting area.
+     */
+    template <typename Collection>
+    void query(Box<2> const& area, Collection& ids) const
+    {
+        int stack[kStackSize];
+        int top = 0;
+
+        stack[top++] = root_;
+
+        while(top > 0)
+        {
+            Node const& node = nodes_[stack[--top]];
+
+            for(int e = node.first; e != -1; e = entries_[e].next)
+            {
+                if(entries_[e].box.intersects(area))
+                {
+                    ids.push_back(e);
+                }
+            }
+
+            for(int i = 0; i < 4; ++i)
+            {
+                const int child = node.children[i];
+
+                if(child != -1 && nodes_[child].loose.intersects(area))
+                {
+                    stack[top++] = child;
+                }
+            }
+        }
+    }
+
+    /**
+     * Fills the given collection with the ids of the objects containing p.
+     */
+    template <typename Collection>
+    void query(Point<2> const& p, Collection& ids) const
+    {
+        query(Box<2>(p, p), ids);
+    }
+
+private:
+    static const int kMaxDepth = 16;
+
+    // Depth first traversal keeps at most 3 siblings per level waiting.
+    static const int kStackSize = 3 * kMaxDepth + 4;
+
+    struct Node
+    {
+        Box<2> cell;
+        Box<2> loose;
+        int parent;
+        int depth;
+        int children[4];
+
+        // Head of the list of objects stored in this node
+        int first;
+
+        // Pool bookkeeping, true while the node is in the free list.
+        bool isFree;
+    };
+
+    struct Entry
+    {
+        Box<2> box;
+        int node;
+        int prev;
+        int next;
+    };
+
+    int allocateNode(int parent, Box<2> const& cell)
+    {
+        int index;
+
+        if(freeNode_ != -1)
+        {
+            index = freeNode_;
+            freeNode_ = nodes_[index].first;
+        }
+        else
+        {
+            index = nodes_.size();
+            nodes_.push_back(Node());
+        }
+
+        Node& node = nodes_[index];
+        const double halfWidth = cell.extent(0) / 2;
+        const double halfHeight = cell.extent(1) / 2;
+
+        node.cell = cell;
+        node.loose = Box<2>(point(cell.getMin()[0] - halfWidth, cell.getMin()[1] - halfHeight),
+                            point(cell.getMax()[0] + halfWidth, cell.getMax()[1] + halfHeight));
+        node.parent = parent;
+        node.depth = parent == -1 ? 0 : nodes_[parent].depth + 1;
+        node.first = -1;
+        node.isFree = false;
+
+        for(int i = 0; i < 4; ++i)
+        {
+            node.children[i] = -1;
+        }
+
+        return index;
+    }
+
+    void releaseNode(int index)
+    {
+        nodes_[index].isFree = true;
+        nodes_[index].first = freeNode_;
+        freeNode_ = index;
+    }
+
+    int allocateEntry()
+    {
+        if(freeEntry_ != -1)
+        {
+            const int index = freeEntry_;
+            freeEntry_ = entries_[index].next;
+            return index;
+        }
+
+        entries_.push_back(Entry());
+        return entries_.size() - 1;
+    }
+
+    void releaseEntry(int index)
+    {
+        entries_[index].node = -1;
+        entries_[index].next = freeEntry_;
+        freeEntry_ = index;
+    }
+
+    void link(int id, int node)
+    {
+        Entry& entry = entries_[id];
+
+        entry.node = node;
+        entry.prev = -1;
+        entry.next = nodes_[node].first;
+
+        if(entry.next != -1)
+        {
+            entries_[entry.next].prev = id;
+        }
+
+        nodes_[node].first = id;
+    }
+
+    void unlink(int id)
+    {
+        Entry& entry = entries_[id];
+
+        if(entry.prev != -1)
+        {
+            entries_[entry.prev].next = entry.next;
+        }
+        else
+        {
+            nodes_[entry.node].first = entry.next;
+        }
+
+        if(entry.next != -1)
+        {
+            entries_[entry.next].prev = entry.prev;
+        }
+    }
+
+    /**
+     * Finds the node that box belongs to, creating the missing nodes
+     * on the way.
+     */
+    int findNode(Box<2> const& box)
+    {
+        const Point<2> center = box.center();
+        int node = root_;
+
+        if(!nodes_[root_].cell.contains(center))
+        {
+            return root_;
+        }
+
+        while(nodes_[node].depth < maxDepth_)
+        {
+            Box<2> const& cell = nodes_[node].cell;
+            const Point<2> mid = cell.center();
+
+            // Objects larger than a child cell stay here
+            if(box.extent(0) > cell.extent(0) / 2 || box.extent(1) > cell.extent(1) / 2)
+            {
+                break;
+            }
+
+            const int quadrant = (center[0] < mid[0] ? 0 : 1) + (center[1] < mid[1] ? 0 : 2);
+            int child = nodes_[node].children[quadrant];
+
+            if(child == -1)
+            {
+                const Point<2> min = point(quadrant & 1 ? mid[0] : cell.getMin()[0],
+                                           quadrant & 2 ? mid[1] : cell.getMin()[1]);
+                const Point<2> max = point(quadrant & 1 ? cell.getMax()[0] : mid[0],
+                                           quadrant & 2 ? cell.getMax()[1] : mid[1]);
+
+                child = allocateNode(node, Box<2>(min, max));
+                nodes_[node].children[quadrant] = child;
+            }
+
+            node = child;
+        }
+
+        return node;
+    }
+
+    /**
+     * True if findNode() may still place box in node, that is the box
+     * fits in the loose bounds and is too large for a child cell. Objects
+     * outside of the world stay at the root.
+     */
+    bool canStay(int node, Box<2> const& box) const
+    {
+        Node const& current = nodes_[node];
+
+        if(node == root_ && !current.cell.contains(box.center()))
+        {
+            return true;
+        }
+
+        if(node != root_ && !current.loose.contains(box))
+        {
+            return false;
+        }
+
+        return current.depth >= maxDepth_ ||
+            box.extent(0) > current.cell.extent(0) / 2 ||
+            box.extent(1) > current.cell.extent(1) / 2;
+    }
+
+    /**
+     * Moves the object and returns the node it left
+     * or -1 if it stayed in the same node.
+     */
+    int relocate(int id, Box<2> const& box)
+    {
+        const int node = entries_[id].node;
+
+        entries_[id].box = box;
+
+        if(canStay(node, box))
+        {
+            return -1;
+        }
+
+        unlink(id);
+        link(id, findNode(box));
+
+        return node;
+    }
+
+    /**
+     * Releases node and its ancestors as long as they are empty leaves.
+     */
+    void prune(int node)
+    {
+        while(node != root_ && !nodes_[node].isFree && nodes_[node].first == -1)
+        {
+            Node& current = nodes_[node];
+
+            for(int i = 0; i < 4; ++i)
+            {
+                if(current.children[i] != -1)
+                {
+                    return;
+                }
+            }
+
+            const int parent = current.parent;
+
+            for(int i = 0; i < 4; ++i)
+            {
+                if(nodes_[parent].children[i] == node)
+                {
+                    nodes_[parent].children[i] = -1;
+                }
+            }
+
+            releaseNode(node);
+            node = parent;
+        }
+    }
+
+private:
+    std::vector<Node> nodes_;
+    std::vector<Entry> entries_;
+    std::vector<int> vacated_;
+    int maxDepth_;
+    int root_;
+    int freeNode_;
+    int freeEntry_;
+    int size_;
+};
+
+} } // namespace geom/simge
+
+#endif
@@ -27,6 +27,9 @@
 #include <list>
 #include <simge/geom/Point.hpp>
 #include <simge/geom/Edge.hpp>
+#include <simge/geom/Box.hpp>
+#include <simge/geom/Weld.hpp>
+#include <simge/util/Enum.hpp>
 
 namespace simge { namespace geom
 {
@@ -58,8 +61,43 @@ public:
 	}
 };
 
+/**
+ * Direction the vertexes of a polygon go around, as seen from
+ * the positive side of the z axis.
+ */
+class Winding : public util::Enum<int>
+{
+private:
+	Winding(int value)
+	: util::Enum<int>(value)
+	{
+	}
+	
+public:
+	static inline Winding Degenerate()
+	{
+		return Winding(0);
+	}
+	
+	static inline Winding Clockwise()
+	{
+		return Winding(1);
+	}
+	
+	static inline Winding CounterClockwise()
+	{
+		return Winding(2);
+	}
+};
+
 /**
  * A polygon.
+ *
+ * The bounding box, signed area, centroid and winding are computed on
+ * first use and cached until the vertexes change. Taking a mutable
+ * iterator drops the cache, code that keeps a mutable iterator across
+ * a query of the cached properties and then changes vertexes must call
+ * invalidate() afterwards. Read only code should use a const polygon.
  */
 template <int Dim>
 class Polygon
@@ -70,7 +108,7 @@ public:
     typedef typename Vertexes::const_iterator const_iterator;
 
     Polygon()
-    : type_(PolygonType::LeftIsInterior())
+    : type_(PolygonType::LeftIsInterior()), cached_(false)
     {
     }
 
@@ -82,7 +120,7 @@ public:
      * If the type is RightInterior then the reverse of the above is correct.
      */
     Polygon(PolygonType type)
-    : type_(type)
+    : type_(type), cached_(false)
     {
     }
     
@@ -100,13 +138,16 @@ public:
     void addVertex(Point<Dim> const& vertex)
     {
         vertexes_.push_back(vertex);
+        invalidate();
     }
     
     //
-    // Return iterators for the vertexes.
+    // Return iterators for the vertexes. The mutable iterators may be used
+    // to change vertexes, so taking one drops the cached properties.
     //
     iterator begin()
     {
+        invalidate();
         return vertexes_.begin();
     }
     
@@ -117,6 +158,7 @@ public:
     
     iterator end()
     {
+        invalidate();
         return vertexes_.end();
     }
     
@@ -136,18 +178,110 @@ public:
     void clear()
     {
         vertexes_.clear();
+        invalidate();
     }
     
     inline iterator insert(iterator pos, Point<Dim> elem)
     {
+        invalidate();
         return vertexes_.insert(pos, elem);
     }
     
     iterator erase(iterator it)
     {
+        invalidate();
         return vertexes_.erase(it);
     }
 
+    /**
+     * Snaps the vertexes to a grid with the given spacing and removes
+     * the vertexes that become equal to the vertex before them.
+     */
+    void normalize(double grid)
+    {
+        VertexWelder<Dim> welder(grid);
+        int previous = -1;
+
+        for(iterator it = begin(); it != end();)
+        {
+            const int index = welder.weld(*it);
+
+            if(index == previous)
+            {
+                it = vertexes_.erase(it);
+            }
+            else
+            {
+                *it = welder.getVertexes()[index];
+                previous = index;
+                ++it;
+            }
+        }
+
+        // The last vertex may have become equal to the first one
+        if(vertexes_.size() > 1 && welder.weld(vertexes_.back()) == welder.weld(vertexes_.front()))
+        {
+            vertexes_.pop_back();
+        }
+
+        invalidate();
+    }
+
+    /**
+     * Drops the cached properties. Must be called after changing vertexes
+     * through an iterator taken before the cached properties were used.
+     */
+    void invalidate()
+    {
+        cached_ = false;
+    }
+
+    /**
+     * Smallest axis aligned box containing all vertexes.
+     */
+    Box<Dim> const& getBounds() const
+    {
+        update();
+        return bounds_;
+    }
+
+    /**
+     * Area of the polygon projected to the xy plane. Positive if the
+     * vertexes are in counter-clockwise order, negative otherwise.
+     */
+    double getSignedArea() const
+    {
+        update();
+        return area_;
+    }
+
+    /**
+     * Center of mass of the polygon. For polygons with zero area
+     * this is the average of the vertexes.
+     */
+    Point<Dim> const& getCentroid() const
+    {
+        update();
+        return centroid_;
+    }
+
+    Winding getWinding() const
+    {
+        const double area = getSignedArea();
+
+        if(area > 0)
+        {
+            return Winding::CounterClockwise();
+        }
+
+        if(area < 0)
+        {
+            return Winding::Clockwise();
+        }
+
+        return Winding::Degenerate();
+    }
+
     /**
      * Split the part of this polygon specified by
      * the interval [begin, end) into a new polygon.
@@ -186,9 +320,73 @@ public:
         }
     }
     
+private:
+    /**
+     * Computes the cached properties if they are not valid.
+     */
+    void update() const
+    {
+        if(cached_)
+        {
+            return;
+        }
+
+        Point<Dim> sum;
+        double twiceArea = 0, cx = 0, cy = 0;
+
+        bounds_ = Box<Dim>();
+
+        for(int i = 0; i < Dim; ++i)
+        {
+            sum[i] = 0;
+        }
+
+        for(const_iterator it = begin(), e = end(), next; it != e; ++it)
+        {
+            next = it;
+            if(++next == e)
+            {
+                next = begin();
+            }
+
+            Point<Dim> const& p = *it;
+            Point<Dim> const& q = *next;
+            const double cross = p[0] * q[1] - q[0] * p[1];
+
+            twiceArea += cross;
+            cx += (p[0] + q[0]) * cross;
+            cy += (p[1] + q[1]) * cross;
+            bounds_.extend(p);
+
+            for(int i = 0; i < Dim; ++i)
+            {
+                sum[i] += p[i];
+            }
+        }
+
+        area_ = twiceArea / 2;
+
+        for(int i = 0; i < Dim; ++i)
+        {
+            centroid_[i] = vertexes_.empty() ? 0 : sum[i] / vertexes_.size();
+        }
+
+        if(twiceArea != 0)
+        {
+            centroid_[0] = cx / (3 * twiceArea);
+            centroid_[1] = cy / (3 * twiceArea);
+        }
+
+        cached_ = true;
+    }
+
 private:
     Vertexes vertexes_;
     PolygonType type_;
+    mutable Box<Dim> bounds_;
+    mutable Point<Dim> centroid_;
+    mutable double area_;
+    mutable bool cached_;
 };
  
 template <typename Collection>
@@ -0,0 +1,274 @@
+/*
+ * Copyright (c) 2006 Emir UNER
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef SIMGE_GEOM_WELD_HPP_INCLUDED
+#define SIMGE_GEOM_WELD_HPP_INCLUDED
+
+#include <math.h>
+#include <cstddef>
+#include <cstring>
+#include <vector>
+#include <unordered_map>
+
+#include <simge/geom/Point.hpp>
+
+namespace simge { namespace geom
+{
+
+/**
+ * Index of the grid node nearest to a point.
+ */
+template <int Dim>
+struct GridKey
+{
+    long long cells[Dim];
+};
+
+template <int Dim>
+inline bool operator==(GridKey<Dim> const& lhs, GridKey<Dim> const& rhs)
+{
+    for(int i = 0; i < Dim; ++i)
+    {
+        if(lhs.cells[i] != rhs.cells[i])
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+template <int Dim>
+struct GridKeyHash
+{
+    std::size_t operator()(GridKey<Dim> const& key) const
+    {
+        unsigned long long hash = 14695981039346656037ULL;
+
+        for(int i = 0; i < Dim; ++i)
+        {
+            hash ^= static_cast<unsigned long long>(key.cells[i]);
+            hash *= 1099511628211ULL;
+            hash ^= hash >> 29;
+        }
+
+        return static_cast<std::size_t>(hash);
+    }
+};
+
+// Largest grid cell index a key holds, well inside the range of long long.
+// Doubles this far from the origin are spaced wider than the grid anyway.
+const double kMaxGridCell = 4e18;
+
+/**
+ * True if every coordinate of p is finite and its grid cell index fits
+ * in a key. Points out of range should be compared exactly instead.
+ */
+template <int Dim>
+inline bool isInGridRange(Point<Dim> const& p, double grid)
+{
+    for(int i = 0; i < Dim; ++i)
+    {
+        if(!(fabs(p[i] / grid) < kMaxGridCell))
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+/**
+ * Finds the key of the grid node nearest to p on a grid with
+ * the given spacing. Cell indexes out of range are clamped, so
+ * distinct points out of range may share a key, see isInGridRange().
+ */
+template <int Dim>
+inline GridKey<Dim> gridKey(Point<Dim> const& p, double grid)
+{
+    GridKey<Dim> key;
+
+    for(int i = 0; i < Dim; ++i)
+    {
+        const double cell = floor(p[i] / grid + 0.5);
+
+        if(cell >= kMaxGridCell)
+        {
+            key.cells[i] = static_cast<long long>(kMaxGridCell);
+        }
+        else if(cell <= -kMaxGridCell)
+        {
+            key.cells[i] = -static_cast<long long>(kMaxGridCell);
+        }
+        else if(cell == cell)
+        {
+            key.cells[i] = static_cast<long long>(cell);
+        }
+        else
+        {
+            key.cells[i] = 0;
+        }
+    }
+
+    return key;
+}
+
+/**
+ * Key made of the exact coordinates of p, for points out of grid range.
+ */
+template <int Dim>
+inline GridKey<Dim> exactKey(Point<Dim> const& p)
+{
+    GridKey<Dim> key;
+
+    for(int i = 0; i < Dim; ++i)
+    {
+        // Adding zero turns -0 into 0
+        const double value = p[i] + 0.0;
+
+        memcpy(&key.cells[i], &value, sizeof(value));
+    }
+
+    return key;
+}
+
+/**
+ * Moves p to the nearest grid node. Points out of grid range
+ * are returned unchanged.
+ */
+template <int Dim>
+inline Point<Dim> snap(Point<Dim> const& p, double grid)
+{
+    if(!isInGridRange(p, grid))
+    {
+        return p;
+    }
+
+    const GridKey<Dim> key = gridKey(p, grid);
+    Point<Dim> result;
+
+    for(int i = 0; i < Dim; ++i)
+    {
+        result[i] = key.cells[i] * grid;
+    }
+
+    return result;
+}
+
+/**
+ * Merges points that snap to the same grid node.
+ * Each distinct grid node gets an index in the order it is first seen,
+ * finding it takes constant expected time. Points out of grid range
+ * are only merged with equal points and are not snapped.
+ */
+template <int Dim>
+class VertexWelder
+{
+public:
+    VertexWelder(double grid)
+    : grid_(grid)
+    {
+    }
+
+    /**
+     * Returns the index of the welded vertex for p.
+     */
+    int weld(Point<Dim> const& p)
+    {
+        if(!isInGridRange(p, grid_))
+        {
+            return weldExact(p);
+        }
+
+        const GridKey<Dim> key = gridKey(p, grid_);
+        typename Indexes::iterator it = indexes_.find(key);
+
+        if(it != indexes_.end())
+        {
+            return it->second;
+        }
+
+        Point<Dim> snapped;
+
+        for(int i = 0; i < Dim; ++i)
+        {
+            snapped[i] = key.cells[i] * grid_;
+        }
+
+        const int index = vertexes_.size();
+
+        vertexes_.push_back(snapped);
+        indexes_.insert(std::make_pair(key, index));
+
+        return index;
+    }
+
+    /**
+     * The welded vertexes, snapped to the grid.
+     */
+    std::vector<Point<Dim> > const& getVertexes() const
+    {
+        return vertexes_;
+    }
+
+    double getGrid() const
+    {
+        return grid_;
+    }
+
+    void clear()
+    {
+        indexes_.clear();
+        exactIndexes_.clear();
+        vertexes_.clear();
+    }
+
+private:
+    typedef std::unordered_map<GridKey<Dim>, int, GridKeyHash<Dim> > Indexes;
+
+    int weldExact(Point<Dim> const& p)
+    {
+        const GridKey<Dim> key = exactKey(p);
+        typename Indexes::iterator it = exactIndexes_.find(key);
+
+        if(it != exactIndexes_.end())
+        {
+            return it->second;
+        }
+
+        const int index = vertexes_.size();
+
+        vertexes_.push_back(p);
+        exactIndexes_.insert(std::make_pair(key, index));
+
+        return index;
+    }
+
+    double grid_;
+    Indexes indexes_;
+    Indexes exactIndexes_;
+    std::vector<Point<Dim> > vertexes_;
+};
+
+} } // namespace geom/simge
+
+#endif
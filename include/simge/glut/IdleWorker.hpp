@@ -39,14 +39,40 @@ public:
 };
 
 /**
- * Add an IdleWorker to list.
+ * Add an IdleWorker to list with priority 0.
  */
 void addIdleWorker(IdleWorker* idleWorker);
 
 /**
- * Remove an IdleWorker from list.
+ * Add an IdleWorker to list. Workers with a higher priority run first in
+ * every idle tick, workers of the same priority in the order they were
+ * added. With an idle budget waiting workers are moved up, see
+ * setIdleBudget(). Workers added while the list is dispatched run from
+ * the next tick on.
+ */
+void addIdleWorker(IdleWorker* idleWorker, int priority);
+
+/**
+ * Remove an IdleWorker from list. May be called from inside idle(), also
+ * for the worker being run.
  */
 void removeIdleWorker(IdleWorker* idleWorker);
+
+/**
+ * Limit the time spent in one idle tick to the given number of seconds,
+ * 0 meaning no limit, the default. A worker is not started if its average
+ * runtime does not fit in what is left of the budget, except that at
+ * least one worker runs every tick. A skipped worker's priority rises by
+ * one for every tick it waits, so workers are delayed by more important
+ * ones but never starved.
+ */
+void setIdleBudget(double seconds);
+
+/**
+ * Average runtime of the worker's idle() in seconds, weighted towards
+ * recent runs. 0 if the worker has not run yet or is not in the list.
+ */
+double getIdleRuntime(IdleWorker* idleWorker);
  
 } } // namespace glut/simge
 
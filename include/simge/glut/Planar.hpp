@@ -24,13 +24,14 @@
 #define SIMGE_GLUT_PLANAR_HPP_INCLUDED
 
 #include <simge/glut/Window.hpp>
+#include <simge/geom/Box.hpp>
 
 namespace simge { namespace glut
 {
     
 /**
  * Provides a 2D area. Lower left (0, 0) upper right
- * (window width, window height).
+ * (window width, window height), unless the view is panned or zoomed.
  */
 class Planar : public Window
 {
@@ -45,8 +46,47 @@ public:
      */
     inline geom::Point<2> windowToGl(int x, int y)
     {
-        return geom::point(x, getHeight() - y);
+        return geom::point(origin_[0] + x / scale_, origin_[1] + (getHeight() - y) / scale_);
     }
+
+    /**
+     * Shows the area whose lower left corner is origin with scale pixels
+     * per unit. The current window is left unchanged. Nothing changes if
+     * scale is not positive and finite.
+     */
+    void setView(geom::Point<2> const& origin, double scale);
+
+    /**
+     * Moves the view by the given window pixels.
+     */
+    void pan(int dx, int dy);
+
+    /**
+     * Multiplies the scale by factor keeping the point under window
+     * position (x, y) in place. Nothing changes if factor is not positive.
+     */
+    void zoom(double factor, int x, int y);
+
+    /**
+     * The OpenGL coordinates of the lower left corner of the window.
+     */
+    inline geom::Point<2> const& getOrigin() const
+    {
+        return origin_;
+    }
+
+    /**
+     * Pixels per unit.
+     */
+    inline double getScale() const
+    {
+        return scale_;
+    }
+
+    /**
+     * The area visible in the window in OpenGL coordinates.
+     */
+    geom::Box<2> getVisibleBox();
     
 protected:
     void reshapeGL(int width, int height);
@@ -56,6 +96,12 @@ protected:
      * If subclasses want it they must call base's keyboardGL before theirs.
      */
     void keyboardGL(unsigned char key, int x, int y);
+
+private:
+    void applyView(int width, int height);
+
+    geom::Point<2> origin_;
+    double scale_;
 };
  
 } } // namespace glut/simge
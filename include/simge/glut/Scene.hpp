@@ -0,0 +1,220 @@
+/*
+ * Copyright (c) 2006 Emir UNER
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef SIMGE_GLUT_SCENE_HPP_INCLUDED
+#define SIMGE_GLUT_SCENE_HPP_INCLUDED
+
+#include <GL/glut.h>
+#include <vector>
+#include <memory>
+
+#include <simge/geom/Box.hpp>
+#include <simge/geom/LooseQuadtree.hpp>
+
+namespace simge { namespace glut {
+
+class Scene;
+
+/**
+ * Common base for drawables kept in a Scene. The drawing commands issued
+ * by render() are compiled into a display list, which is replayed until
+ * the node is marked dirty.
+ *
+ * Display lists belong to the window that was current when they were
+ * compiled, so nodes must be drawn and destroyed with that window current.
+ */
+class SceneNode
+{
+    friend class Scene;
+
+public:
+    SceneNode();
+
+    /**
+     * Deletes the display list and removes the node from its scene.
+     */
+    virtual ~SceneNode();
+
+    /**
+     * Marks the node to be compiled again on the next draw.
+     * Call after every change that affects render().
+     */
+    void markDirty();
+
+    bool isDirty() const
+    {
+        return dirty_;
+    }
+
+    /**
+     * Compiles the node if it is dirty and calls its display list.
+     */
+    void draw();
+
+    /**
+     * The area covered by the node, used to skip nodes outside the view.
+     * An empty box, the default, means that the area is not known and
+     * the node is never skipped.
+     */
+    virtual geom::Box<2> getBounds() const;
+
+protected:
+    /**
+     * Called before a dirty node is compiled, outside of the list, to
+     * create the GL objects that render() uses. Does nothing by default.
+     */
+    virtual void prepare();
+
+    /**
+     * Issues the drawing commands of the node.
+     */
+    virtual void render() = 0;
+
+private:
+    SceneNode(SceneNode const&);
+    SceneNode& operator=(SceneNode const&);
+
+    GLuint list_;
+    bool dirty_;
+    Scene* scene_;
+
+    // Position in the scene's order and id in its index, -1 if not indexed
+    int order_;
+    int indexId_;
+
+    // Places in the scene's node vectors, for constant time removal
+    int position_;
+    int unboundedPosition_;
+};
+
+/**
+ * An ordered list of nodes drawn together. The scene remembers whether
+ * anything changed since it was last drawn, so that windows showing it
+ * can skip repaints, see Window::invalidateScene(). Nodes are not owned
+ * by the scene.
+ *
+ * A scene created with a world area keeps the bounds of its nodes in a
+ * LooseQuadtree, so that drawing a view only visits the nodes inside it.
+ */
+class Scene
+{
+public:
+    Scene();
+
+    /**
+     * A scene that indexes its nodes for culling. Nodes outside world are
+     * still found, only less efficiently.
+     */
+    explicit Scene(geom::Box<2> const& world, int maxDepth = 8);
+
+    /**
+     * Detaches the nodes still in the scene.
+     */
+    ~Scene();
+
+    /**
+     * Appends a node. A node can be in one scene only.
+     */
+    void add(SceneNode* node);
+
+    /**
+     * Removes a node in amortized constant time, keeping the order of the
+     * others. Its place is left empty until the next draw() or until half
+     * of the places are empty.
+     */
+    void remove(SceneNode* node);
+
+    /**
+     * Draws the nodes in the order they were added, compiling the dirty
+     * ones, and marks the scene unchanged.
+     * Does not flush.
+     * Assumes that current window valid.
+     */
+    void draw();
+
+    /**
+     * Same as above but draws only the nodes whose bounds intersect
+     * visible, and the nodes without bounds, in the order they were added.
+     */
+    void draw(geom::Box<2> const& visible);
+
+    /**
+     * Marks the scene to be painted again, for changes outside its nodes
+     * such as the projection.
+     */
+    void markChanged()
+    {
+        changed_ = true;
+    }
+
+    /**
+     * True if the scene changed since it was last drawn.
+     */
+    bool isChanged() const
+    {
+        return changed_;
+    }
+
+    typedef std::vector<SceneNode*> NodeVec;
+
+    /**
+     * The nodes, in the order they were added.
+     */
+    NodeVec const& getNodes() const
+    {
+        compact();
+        return nodes_;
+    }
+
+private:
+    friend class SceneNode;
+
+    Scene(Scene const&);
+    Scene& operator=(Scene const&);
+
+    void index(SceneNode* node);
+    void unindex(SceneNode* node);
+    void nodeChanged(SceneNode* node);
+
+    static bool isBefore(SceneNode const* lhs, SceneNode const* rhs);
+    static void removeAt(NodeVec& nodes, int position, int SceneNode::* member);
+    void compact() const;
+
+    // Removed nodes leave 0 behind until compact() drops them, which does
+    // not change what the scene holds
+    mutable NodeVec nodes_;
+    mutable int removed_;
+    bool changed_;
+    int nextOrder_;
+
+    // Culling index, the nodes by their index ids and the nodes without
+    // bounds in no particular order
+    std::unique_ptr<geom::LooseQuadtree> index_;
+    NodeVec indexed_;
+    NodeVec unbounded_;
+    NodeVec visible_;
+    std::vector<int> found_;
+};
+
+} } // namespace glut/simge
+
+#endif
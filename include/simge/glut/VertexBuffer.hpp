@@ -0,0 +1,117 @@
+/*
+ * Copyright (c) 2006 Emir UNER
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef SIMGE_GLUT_VERTEXBUFFER_HPP_INCLUDED
+#define SIMGE_GLUT_VERTEXBUFFER_HPP_INCLUDED
+
+#include <GL/glut.h>
+#include <cstddef>
+#include <vector>
+
+namespace simge { namespace glut {
+
+/**
+ * Vertex data kept in an OpenGL buffer object when the OpenGL version is
+ * at least 1.5, and in client memory otherwise. Pointers passed to
+ * glVertexPointer and the like are obtained with getPointer() after
+ * bind(), so that the same drawing code works in both cases.
+ *
+ * All member functions assume that the same OpenGL context is current.
+ */
+class VertexBuffer
+{
+public:
+    VertexBuffer();
+
+    /**
+     * Deletes the buffer object, if any.
+     */
+    ~VertexBuffer();
+
+    /**
+     * Replaces the contents with size bytes at data.
+     */
+    void upload(void const* data, std::size_t size);
+
+    /**
+     * Resizes the buffer to size bytes with undefined contents.
+     */
+    void allocate(std::size_t size);
+
+    /**
+     * Replaces size bytes starting at offset with the bytes at data.
+     * Assumes that offset + size <= size().
+     */
+    void update(std::size_t offset, void const* data, std::size_t size);
+
+    /**
+     * Binds the buffer to GL_ARRAY_BUFFER if it is a buffer object.
+     */
+    void bind() const;
+
+    /**
+     * Restores the GL_ARRAY_BUFFER binding to none.
+     */
+    void unbind() const;
+
+    /**
+     * The pointer to pass to gl*Pointer for the byte at offset.
+     * Valid only while the buffer is bound.
+     */
+    void const* getPointer(std::size_t offset) const;
+
+    /**
+     * Size of the contents in bytes.
+     */
+    std::size_t size() const
+    {
+        return size_;
+    }
+
+    /**
+     * True if the contents are in a buffer object.
+     */
+    bool isBufferObject() const
+    {
+        return id_ != 0;
+    }
+
+    /**
+     * True if the current context is at least OpenGL 1.5 and the buffer
+     * object functions could be looked up with glutGetProcAddress.
+     */
+    static bool isSupported();
+
+private:
+    VertexBuffer(VertexBuffer const&);
+    VertexBuffer& operator=(VertexBuffer const&);
+
+    void create();
+
+    GLuint id_;
+    std::size_t size_;
+    std::vector<char> client_;
+};
+
+} } // namespace glut/simge
+
+#endif
@@ -25,9 +25,12 @@
 
 #include <GL/glut.h>
 #include <simge/glut/Point.hpp>
+#include <vector>
 
 namespace simge { namespace glut {
 
+class Scene;
+
 /**
  * A GLUT window.
  * Only inside callback functions it is guaranteed that the current window
@@ -74,14 +77,54 @@ public:
     void swapBuffers();
     
     /**
-     * Forces a repaint as soon as possible.
+     * Forces a repaint as soon as possible. Does nothing while queued
+     * input events are delivered just before a repaint.
      */
     void invalidate();
 
+    /**
+     * Same as invalidate() but does nothing if a scene is attached and it
+     * did not change since it was last drawn. For handlers that only
+     * change the scene, such as ones called on every mouse move.
+     */
+    void invalidateScene();
+
+    /**
+     * Switches input coalescing on or off. When on, mouse, motion and
+     * keyboard events are queued, a repaint is posted, and the events are
+     * delivered in order just before paintGL(). Consecutive motion events
+     * of the same kind are collapsed into the latest position, so a burst
+     * of motion costs one handler call and one repaint. When off, the
+     * default, every event is delivered as GLUT reports it.
+     */
+    void setInputCoalescing(bool coalescing);
+
+    bool isInputCoalescing() const;
+
+    /**
+     * Attaches a scene, or detaches it if
+     * scene is 0. paintGL() is expected to draw it with Scene::draw().
+     * The scene is not owned by the window.
+     */
+    void setScene(Scene* scene);
+
+    /**
+     * The attached scene, 0 if there is none.
+     */
+    Scene* getScene() const;
+
     /**
      * Return a reference to current window.
+     * Throws std::runtime_error if the current window was not created
+     * through this class.
      */
     static Window& currentWindow();
+
+    /**
+     * Registers a function called with the id of every window that is
+     * destroyed afterwards, so that per window caches can be dropped.
+     */
+    static void addDestroyListener(void (*listener)(int id));
     
 protected:
     inline virtual void paintGL() {}
@@ -98,9 +141,28 @@ private:
     static void motionCallbackDispatcher(int x, int y);
     static void passiveMotionCallbackDispatcher(int x, int y);
     static void keyboardCallbackDispatcher(unsigned char key, int x, int y);
+
+    struct InputEvent
+    {
+        enum Type { Mouse, Motion, PassiveMotion, Keyboard };
+
+        Type type;
+        int button;
+        int state;
+        int x;
+        int y;
+        unsigned char key;
+    };
+
+    void queue(InputEvent const& event);
+    void deliverQueued(bool beforePaint);
     
 private:
     int id_;
+    Scene* scene_;
+    bool coalescing_;
+    bool delivering_;
+    std::vector<InputEvent> events_;
 };
 
 } } // namespace glut/simge
@@ -0,0 +1,274 @@
+/*
+ * Copyright (c) 2006 Emir UNER
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef SIMGE_UTIL_BINARYPOLYLINEFILE_HPP_INCLUDED
+#define SIMGE_UTIL_BINARYPOLYLINEFILE_HPP_INCLUDED
+
+#include <cstddef>
+#include <cstdio>
+#include <vector>
+#include <stdexcept>
+
+#include <simge/util/MappedFile.hpp>
+#include <simge/util/MappedPolylineFile.hpp>
+
+//
+// Binary polyline files store the same data as the text polyline files in
+// columns so that they can be used directly from a memory mapping:
+//
+//   header      64 bytes, see BinaryPolylineHeader
+//   coordinates pointCount * dimension floats or doubles
+//   offsets     polylineCount + 1 uint64 point indexes, polyline i is
+//               the points [offsets[i], offsets[i + 1])
+//   colors      polylineCount * 3 uint16 r, g, b components
+//
+// Every section starts at a multiple of 8 bytes. Numbers are stored in the
+// byte order of the machine that wrote the file. Closed polylines are
+// stored with their first point repeated at the end, as read from text.
+//
+
+namespace simge { namespace util
+{
+
+struct BinaryPolylineHeader
+{
+    char magic[8];
+    unsigned int byteOrder;
+    unsigned int version;
+    unsigned int dimension;
+    unsigned int scalarSize;
+    unsigned long long polylineCount;
+    unsigned long long pointCount;
+    unsigned long long coordinatesPos;
+    unsigned long long offsetsPos;
+    unsigned long long colorsPos;
+};
+
+/**
+ * Points of one polyline in a binary polyline file.
+ */
+template <typename PointType>
+struct PolylineSpan
+{
+    PointType const* points;
+    std::size_t count;
+    Color color;
+
+    PointType const* begin() const
+    {
+        return points;
+    }
+
+    PointType const* end() const
+    {
+        return points + count;
+    }
+};
+
+/**
+ * Reads a binary polyline file through a memory mapping. Opening the file
+ * checks the header and the offsets, polylines are accessed in place.
+ */
+class BinaryPolylineFile
+{
+public:
+    /**
+     * Maps the file with the given path.
+     * Throws std::runtime_error if the file cannot be mapped, is not
+     * a binary polyline file written on a machine with the same byte order,
+     * or its sections do not fit in the file or its offsets are not in order.
+     */
+    BinaryPolylineFile(char const* path);
+
+    int getPolylineCount() const
+    {
+        return header_->polylineCount;
+    }
+
+    /**
+     * Count of points of all polylines.
+     */
+    std::size_t getTotalPointCount() const
+    {
+        return header_->pointCount;
+    }
+
+    /**
+     * 2 or 3.
+     */
+    int getDimension() const
+    {
+        return header_->dimension;
+    }
+
+    /**
+     * True if coordinates are stored as floats instead of doubles.
+     */
+    bool hasFloatCoordinates() const
+    {
+        return header_->scalarSize == sizeof(float);
+    }
+
+    std::size_t getPointCount(int i) const
+    {
+        return offsets_[i + 1] - offsets_[i];
+    }
+
+    Color getColor(int i) const
+    {
+        return Color(colors_[3 * i], colors_[3 * i + 1], colors_[3 * i + 2]);
+    }
+
+    /**
+     * Coordinates of the ith polyline, x0 y0 [z0] x1 y1 [z1] ...
+     * Throws std::logic_error if the coordinates are not doubles.
+     */
+    double const* getDoubles(int i) const;
+
+    /**
+     * Coordinates of the ith polyline, x0 y0 [z0] x1 y1 [z1] ...
+     * Throws std::logic_error if the coordinates are not floats.
+     */
+    float const* getFloats(int i) const;
+
+    /**
+     * The ith polyline without copying its points. PointType must be
+     * geom::Point<getDimension()> and coordinates must be doubles,
+     * otherwise std::logic_error is thrown.
+     */
+    template <typename PointType>
+    PolylineSpan<PointType> get(int i) const
+    {
+        if(sizeof(PointType) != sizeof(double) * getDimension())
+        {
+            throw std::logic_error("binary polyline file has a different dimension");
+        }
+
+        PolylineSpan<PointType> span;
+
+        span.points = reinterpret_cast<PointType const*>(getDoubles(i));
+        span.count = getPointCount(i);
+        span.color = getColor(i);
+
+        return span;
+    }
+
+private:
+    MappedFile file_;
+    BinaryPolylineHeader const* header_;
+    unsigned long long const* offsets_;
+    unsigned short const* colors_;
+    char const* coordinates_;
+};
+
+/**
+ * Writes a binary polyline file. Coordinates are written as polylines are
+ * added, offsets and colors are kept in memory until close().
+ */
+class BinaryPolylineWriter
+{
+public:
+    /**
+     * Creates the file with the given path. Coordinates are
+     * converted to floats if useFloat is true.
+     * Throws std::runtime_error if the file cannot be created.
+     */
+    BinaryPolylineWriter(char const* path, int dimension, bool useFloat = false);
+
+    /**
+     * Closes the file if close() was not called. Errors are ignored.
+     */
+    ~BinaryPolylineWriter();
+
+    /**
+     * Adds a polyline with the given coordinates,
+     * pointCount * dimension doubles.
+     * Throws std::runtime_error on write errors.
+     */
+    void write(double const* coordinates, std::size_t pointCount, Color const& color);
+
+    /**
+     * Adds the points [begin, end) as a polyline.
+     */
+    template <typename PointType>
+    void write(PointType const* begin, PointType const* end, Color const& color)
+    {
+        // Points are plain arrays of doubles
+        checkDimension(sizeof(PointType));
+        write(reinterpret_cast<double const*>(begin), end - begin, color);
+    }
+
+    template <typename PointType>
+    void write(Polyline<PointType> const& line)
+    {
+        PointType const* points = line.points.empty() ? 0 : &line.points[0];
+
+        write(points, points + line.points.size(), line.color);
+    }
+
+    /**
+     * Writes offsets, colors and the header, then closes the file.
+     * Throws std::runtime_error on write errors.
+     */
+    void close();
+
+private:
+    // Not copyable.
+    BinaryPolylineWriter(BinaryPolylineWriter const&);
+    BinaryPolylineWriter& operator=(BinaryPolylineWriter const&);
+
+    void checkDimension(std::size_t pointSize) const;
+    void put(void const* data, std::size_t size);
+    void pad();
+
+    std::FILE* out_;
+    int dimension_;
+    bool useFloat_;
+    unsigned long long pos_;
+    std::vector<unsigned long long> offsets_;
+    std::vector<unsigned short> colors_;
+    std::vector<float> floats_;
+};
+
+/**
+ * Converts a text polyline file to a binary one,
+ * one polyline at a time. PointType selects the dimension.
+ */
+template <typename PointType>
+void convertPolylineFile(char const* textPath, char const* binaryPath, bool useFloat = false)
+{
+    MappedPolylineFile<PointType> in(textPath);
+    BinaryPolylineWriter out(binaryPath, sizeof(PointType) / sizeof(double), useFloat);
+    PolylineArena<PointType> arena;
+
+    while(in.readNext(arena))
+    {
+        out.write(arena.begin(0), arena.end(0), arena.lines[0].color);
+        arena.clear();
+    }
+
+    out.close();
+}
+
+} } // namespace util/simge
+
+#endif
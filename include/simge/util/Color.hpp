@@ -24,6 +24,7 @@
 #define SIMGE_UTIL_COLOR_HPP_INCLUDED
 
 #include <iosfwd>
+#include <string_view>
 
 namespace simge { namespace util
 {
@@ -83,13 +84,38 @@ void clearColor(Color const& color);
  */    
 bool operator!=(Color const& lhs, Color const& rhs);
 
+/**
+ * Parses the len characters at str as a color formatted as one of
+ * #rgb, #rrggbb or #rrrrggggbbbb. Returns false if the format is wrong.
+ * The digits of the short forms are the high digits of the components,
+ * #f00 and #ff0000 are read as 0xf000 and 0xff00 red.
+ */
+bool parseColor(char const* str, int len, Color& color);
+
+/**
+ * Same as above for the characters of str.
+ */
+bool parseColor(std::string_view str, Color& color);
+
+/**
+ * Maximum count of characters written by formatColor.
+ */
+const int kMaxColorChars = 13;
+
+/**
+ * Writes the color at out in the smallest form that parseColor reads
+ * back to the same color, without a terminating null. Returns the
+ * position after the last character.
+ */
+char* formatColor(char* out, Color const& color);
+
 /**
  * Reads a color formatted as one of #rgb, #rrggbb or #rrrrggggbbbb
  */
 std::istream& operator>>(std::istream& in, Color& color);
 
 /**
- * Writes the color in the smallest form that is possible.
+ * Writes the color as formatColor does.
  */
 std::ostream& operator<<(std::ostream& out, Color const& color);
 
@@ -0,0 +1,59 @@
+/*
+ * Copyright (c) 2006 Emir UNER
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef SIMGE_UTIL_FORMAT_HPP_INCLUDED
+#define SIMGE_UTIL_FORMAT_HPP_INCLUDED
+
+//
+// Formatting of numbers into character buffers, the counterpart of Scan.
+// Every function writes at out without a terminating null and returns the
+// position after the last written character. The output does not depend
+// on the locale.
+//
+
+namespace simge { namespace util
+{
+
+/**
+ * Maximum count of characters written by formatInt.
+ */
+const int kMaxIntChars = 11;
+
+/**
+ * Maximum count of characters written by formatDouble.
+ */
+const int kMaxDoubleChars = 24;
+
+/**
+ * Writes a decimal integer.
+ */
+char* formatInt(char* out, int value);
+
+/**
+ * Writes the shortest decimal form of value that scans back to the same
+ * double.
+ */
+char* formatDouble(char* out, double value);
+
+} } // namespace util/simge
+
+#endif
@@ -0,0 +1,115 @@
+/*
+ * Copyright (c) 2006 Emir UNER
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef SIMGE_UTIL_LSYSTEM_HPP_INCLUDED
+#define SIMGE_UTIL_LSYSTEM_HPP_INCLUDED
+
+#include <string>
+#include <vector>
+#include <cstddef>
+
+#include <simge/util/Turtle.hpp>
+
+namespace simge { namespace util {
+
+/**
+ * A deterministic context free L-system interpreted by a Turtle.
+ *
+ * Symbols are interpreted as:
+ *   F, G   forward drawing a line
+ *   f      forward without drawing
+ *   +      turn left by the angle
+ *   -      turn right by the angle
+ *   [      save position and direction
+ *   ]      restore the last saved position and direction
+ * Other symbols are only used by the rules.
+ *
+ * Rules are expanded lazily while the turtle walks, so memory use depends
+ * on the iteration depth and the bracket nesting but not on the length of
+ * the expanded string.
+ */
+class LSystem
+{
+public:
+    /**
+     * A system with the given axiom, step length and turn angle in degrees.
+     * Throws std::runtime_error if the brackets of axiom are not balanced.
+     */
+    LSystem(char const* axiom, double step, double angle);
+
+    /**
+     * Replaces symbol with replacement in every iteration.
+     * Throws std::runtime_error if the brackets of replacement are not
+     * balanced.
+     */
+    void addRule(char symbol, char const* replacement);
+
+    /**
+     * Count of lines drawn when interpreting depth iterations.
+     * Saturates at the largest value of the type.
+     */
+    unsigned long long countSegments(int depth) const;
+
+    /**
+     * Walks the turtle through depth iterations of the system. If the
+     * turtle is recording, its recording is flushed whenever it holds
+     * flushEvery segments, which requires a current window.
+     */
+    void interpret(Turtle& turtle, int depth, std::size_t flushEvery = 1 << 16) const;
+
+    /**
+     * Same as interpret but expands independent parts of the system on
+     * threadCount threads, 0 meaning one per hardware thread. Every part
+     * is walked by its own turtle starting at (0, 0), and its lines are
+     * passed on in chunks of flushEvery segments. The chunks are rotated
+     * and moved to where the parts before them left off and appended to
+     * the turtle's recording in order, which is flushed as in interpret if
+     * the turtle is recording. At most a few chunks per thread are kept
+     * in memory, so the threads mostly overlap walking with flushing.
+     */
+    void interpretParallel(Turtle& turtle, int depth, int threadCount = 0,
+                           std::size_t flushEvery = 1 << 16) const;
+
+private:
+    struct ParallelWalk;
+
+    // Called by walk with the turtle when it holds flushEvery segments
+    typedef void (*FlushFunction)(Turtle& turtle, void* context);
+
+    void walk(char const* begin, char const* end, int depth, Turtle& turtle,
+              std::size_t flushEvery, FlushFunction flush, void* context) const;
+
+    // Lines drawn by every symbol after depth iterations
+    void countSymbolSegments(int depth, std::vector<unsigned long long>& counts) const;
+
+    std::string expand(std::string const& symbols) const;
+
+    std::string axiom_;
+    double step_;
+    double angle_;
+    std::vector<std::string> rules_;
+    std::vector<bool> hasRule_;
+};
+
+} } // namespace util/simge
+
+#endif
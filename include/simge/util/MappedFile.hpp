@@ -0,0 +1,84 @@
+/*
+ * Copyright (c) 2006 Emir UNER
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef SIMGE_UTIL_MAPPEDFILE_HPP_INCLUDED
+#define SIMGE_UTIL_MAPPEDFILE_HPP_INCLUDED
+
+#include <cstddef>
+
+namespace simge { namespace util
+{
+
+/**
+ * A read only memory mapping of a whole file.
+ */
+class MappedFile
+{
+public:
+    /**
+     * Maps the file with the given path.
+     * Throws std::runtime_error if the file cannot be opened or mapped.
+     */
+    MappedFile(char const* path);
+
+    /**
+     * Unmaps the file.
+     */
+    ~MappedFile();
+
+    inline char const* begin() const
+    {
+        return data_;
+    }
+
+    inline char const* end() const
+    {
+        return data_ + size_;
+    }
+
+    inline std::size_t size() const
+    {
+        return size_;
+    }
+
+    /**
+     * Last modification time of the file when it was mapped,
+     * in nanoseconds since the epoch.
+     */
+    inline unsigned long long getModificationTime() const
+    {
+        return modificationTime_;
+    }
+
+private:
+    // Not copyable.
+    MappedFile(MappedFile const&);
+    MappedFile& operator=(MappedFile const&);
+
+    char const* data_;
+    std::size_t size_;
+    unsigned long long modificationTime_;
+};
+
+} } // namespace util/simge
+
+#endif
@@ -0,0 +1,271 @@
+/*
+ * Copyright (c) 2006 Emir UNER
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef SIMGE_UTIL_MAPPEDPOLYLINEFILE_HPP_INCLUDED
+#define SIMGE_UTIL_MAPPEDPOLYLINEFILE_HPP_INCLUDED
+
+#include <stdexcept>
+
+#include <simge/util/MappedFile.hpp>
+#include <simge/util/PolylineArena.hpp>
+#include <simge/util/Scan.hpp>
+
+namespace simge { namespace util
+{
+
+inline bool scanPoint(char const*& cur, char const* end, geom::Point<2>& p)
+{
+    return scanDouble(cur, end, p[0]) && scanDouble(cur, end, p[1]);
+}
+
+inline bool scanPoint(char const*& cur, char const* end, geom::Point<3>& p)
+{
+    return scanDouble(cur, end, p[0]) && scanDouble(cur, end, p[1]) && scanDouble(cur, end, p[2]);
+}
+
+/**
+ * Parses one polyline in the PolylineFile format starting at cur and
+ * appends it to arena. Returns the position after the polyline.
+ * Throws std::runtime_error in case of any syntax error, or if the
+ * point count is larger than the rest of the buffer can hold.
+ */
+template <typename PointType>
+char const* parsePolyline(char const* cur, char const* end, PolylineArena<PointType>& arena)
+{
+    const int dimension = sizeof(PointType) / sizeof(double);
+    typename PolylineArena<PointType>::Entry entry;
+    int pointCount;
+    bool closed = false;
+
+    if(!scanInt(cur, end, pointCount) || pointCount == INT_MIN)
+    {
+        throw std::runtime_error("polyline file format not correct");
+    }
+
+    if(pointCount < 0)
+    {
+        closed = true;
+        pointCount *= -1;
+    }
+
+    // Every coordinate takes at least a digit and the white space before
+    // it, a larger count is a syntax error and must not be allocated
+    if(pointCount > (end - cur) / (2 * dimension))
+    {
+        throw std::runtime_error("polyline file format not correct");
+    }
+
+    cur = skipSpace(cur, end);
+
+    if(cur != end && *cur == '#')
+    {
+        char const* const colorEnd = skipToken(cur, end);
+
+        if(!parseColor(cur, colorEnd - cur, entry.color))
+        {
+            throw std::runtime_error("polyline file format not correct");
+        }
+
+        cur = colorEnd;
+    }
+    else
+    {
+        entry.color = Color::black();
+    }
+
+    entry.first = arena.points.size();
+    entry.count = pointCount + (closed && pointCount > 0 ? 1 : 0);
+
+    // Points are parsed in place, within the capacity reserved by
+    // readAll() unless the estimate was short
+    arena.points.resize(entry.first + entry.count);
+    PointType* out = arena.points.data() + entry.first;
+
+    for(int i = 0; i < pointCount; ++i)
+    {
+        if(!scanPoint(cur, end, out[i]))
+        {
+            arena.points.resize(entry.first);
+            throw std::runtime_error("polyline file format not correct");
+        }
+    }
+
+    if(entry.count > static_cast<std::size_t>(pointCount))
+    {
+        out[pointCount] = out[0];
+    }
+
+    arena.lines.push_back(entry);
+
+    return cur;
+}
+
+/**
+ * Reads a polyline file through a memory mapping of it. Accepts the same
+ * format as PolylineFile but parses the mapped characters directly and
+ * stores all polylines in one PolylineArena.
+ */
+template <typename PointType>
+class MappedPolylineFile
+{
+public:
+    /**
+     * Maps the file with the given path.
+     * Throws std::runtime_error if the file cannot be mapped
+     * or the polyline count cannot be read.
+     */
+    MappedPolylineFile(char const* path)
+    : file_(path), cur_(file_.begin()), read_(0)
+    {
+        if(!scanInt(cur_, file_.end(), count_))
+        {
+            throw std::runtime_error("polyline file error while "
+                                     "reading line count");
+        }
+    }
+
+    /**
+     * Get the count of polylines.
+     */
+    inline int getPolylineCount() const
+    {
+        return count_;
+    }
+
+    /**
+     * Appends all polylines of the file to arena.
+     * Throws std::runtime_error in case of any syntax error.
+     */
+    void readAll(PolylineArena<PointType>& arena)
+    {
+        arena.lines.reserve(arena.lines.size() + count_ - read_);
+
+        // The points are reserved once, estimated from the bytes per
+        // point of the first polylines
+        char const* const sampleBegin = cur_;
+        const std::size_t sampleFirst = arena.points.size();
+
+        for(int i = 0; i < kSampleLines && readNext(arena); ++i)
+        {
+        }
+
+        const std::size_t sampleBytes = cur_ - sampleBegin;
+        const std::size_t samplePoints = arena.points.size() - sampleFirst;
+
+        if(read_ < count_ && sampleBytes > 0 && samplePoints > 0)
+        {
+            const double estimate = static_cast<double>(file_.end() - cur_) * samplePoints / sampleBytes;
+
+            arena.points.reserve(arena.points.size() + static_cast<std::size_t>(estimate * 17 / 16));
+        }
+
+        while(readNext(arena))
+        {
+        }
+    }
+
+    /**
+     * Appends the next polyline of the file to arena.
+     * Returns false if all polylines have been read.
+     * Throws std::runtime_error in case of any syntax error.
+     */
+    bool readNext(PolylineArena<PointType>& arena)
+    {
+        if(read_ == count_)
+        {
+            return false;
+        }
+
+        cur_ = parsePolyline(cur_, file_.end(), arena);
+        ++read_;
+
+        return true;
+    }
+
+    /**
+     * Appends the polyline starting at the given byte offset to arena.
+     * Does not change the position of readNext().
+     * Throws std::runtime_error in case of any syntax error.
+     */
+    void readAt(unsigned long long offset, PolylineArena<PointType>& arena) const
+    {
+        if(offset > file_.size())
+        {
+            throw std::runtime_error("polyline file offset out of range");
+        }
+
+        parsePolyline(file_.begin() + offset, file_.end(), arena);
+    }
+
+    /**
+     * Byte offset of the polyline readNext() reads.
+     */
+    unsigned long long getPosition() const
+    {
+        return cur_ - file_.begin();
+    }
+
+    /**
+     * Count of polylines read by readNext() so far.
+     */
+    int getReadCount() const
+    {
+        return read_;
+    }
+
+    /**
+     * Continues readNext() at the given byte offset as if read polylines
+     * had been read, for readers that parse the polylines themselves.
+     * Throws std::runtime_error if the offset or count is out of range.
+     */
+    void setPosition(unsigned long long offset, int read)
+    {
+        if(offset > file_.size() || read < 0 || read > count_)
+        {
+            throw std::runtime_error("polyline file position out of range");
+        }
+
+        cur_ = file_.begin() + offset;
+        read_ = read;
+    }
+
+    /**
+     * The mapped file contents.
+     */
+    MappedFile const& getFile() const
+    {
+        return file_;
+    }
+
+private:
+    // Polylines read by readAll() before it reserves the points
+    static const int kSampleLines = 64;
+
+    MappedFile file_;
+    char const* cur_;
+    int count_;
+    int read_;
+};
+
+} } // namespace util/simge
+
+#endif
@@ -0,0 +1,420 @@
+/*
+ * Copyright (c) 2006 Emir UNER
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef SIMGE_UTIL_PARALLELPOLYLINEFILE_HPP_INCLUDED
+#define SIMGE_UTIL_PARALLELPOLYLINEFILE_HPP_INCLUDED
+
+#include <vector>
+#include <thread>
+#include <functional>
+#include <exception>
+#include <algorithm>
+#include <stdexcept>
+
+#include <simge/util/MappedPolylineFile.hpp>
+#include <simge/util/PolylineIndex.hpp>
+
+namespace simge { namespace util
+{
+
+/**
+ * Returns the position after the polyline starting at cur without
+ * converting its numbers. dimension is the count of coordinates per point.
+ * Throws std::runtime_error if the file ends early or the count is wrong.
+ */
+inline char const* skipPolyline(char const* cur, char const* end, int dimension)
+{
+    int pointCount;
+
+    if(!scanInt(cur, end, pointCount))
+    {
+        throw std::runtime_error("polyline file format not correct");
+    }
+
+    const long long tokens = (pointCount < 0 ? -static_cast<long long>(pointCount) : pointCount) * dimension;
+
+    cur = skipSpace(cur, end);
+
+    if(cur != end && *cur == '#')
+    {
+        cur = skipToken(cur, end);
+    }
+
+    for(long long i = 0; i < tokens; ++i)
+    {
+        cur = skipSpace(cur, end);
+
+        if(cur == end)
+        {
+            throw std::runtime_error("polyline file format not correct");
+        }
+
+        cur = skipToken(cur, end);
+    }
+
+    return cur;
+}
+
+/**
+ * A range of polylines parsed by one thread. The range starts at begin,
+ * which is past any white space, and ends after limit polylines or at the
+ * first polyline starting at or after stop, whichever comes first.
+ */
+struct PolylineChunk
+{
+    char const* begin;
+    char const* stop;
+    int limit;
+};
+
+namespace detail
+{
+    template <typename PointType>
+    struct ChunkParser
+    {
+        PolylineChunk chunk;
+        char const* end;
+        PolylineArena<PointType> arena;
+        std::exception_ptr error;
+
+        // Position after the last parsed polyline, and after the white
+        // space following it
+        char const* after;
+        char const* last;
+
+        // Polylines of the chunk in the result and where the first goes
+        int used;
+        int first;
+
+        void parse()
+        {
+            arena.clear();
+            error = std::exception_ptr();
+            after = chunk.begin;
+            last = chunk.begin;
+
+            try
+            {
+                while(static_cast<int>(arena.lines.size()) < chunk.limit && last < chunk.stop)
+                {
+                    after = parsePolyline(last, end, arena);
+                    last = skipSpace(after, end);
+                }
+            }
+            catch(...)
+            {
+                error = std::current_exception();
+            }
+        }
+
+        /**
+         * Copies the used polylines to their place in the result.
+         */
+        void copyTo(PolylineArena<PointType>& result, std::size_t pointBase)
+        {
+            const std::size_t points = used == static_cast<int>(arena.lines.size())
+                ? arena.points.size() : arena.lines[used].first;
+
+            std::copy(arena.points.begin(), arena.points.begin() + points, result.points.begin() + pointBase);
+
+            for(int i = 0; i < used; ++i)
+            {
+                result.lines[first + i] = arena.lines[i];
+                result.lines[first + i].first += pointBase;
+            }
+
+            arena.clear();
+        }
+    };
+
+    /**
+     * Threads that are joined when it is destroyed, so that no thread is
+     * left joinable when starting one or a later step throws.
+     */
+    class ThreadGroup
+    {
+    public:
+        explicit ThreadGroup(int count)
+        {
+            // Adding a started thread must not throw
+            threads_.reserve(count);
+        }
+
+        ~ThreadGroup()
+        {
+            join();
+        }
+
+        template <typename Function, typename Object>
+        void start(Function function, Object* object)
+        {
+            threads_.push_back(std::thread(function, object));
+        }
+
+        template <typename Function, typename Object, typename Arg1, typename Arg2>
+        void start(Function function, Object* object, Arg1 arg1, Arg2 arg2)
+        {
+            threads_.push_back(std::thread(function, object, arg1, arg2));
+        }
+
+        void join()
+        {
+            for(std::size_t i = 0; i < threads_.size(); ++i)
+            {
+                threads_[i].join();
+            }
+
+            threads_.clear();
+        }
+
+    private:
+        ThreadGroup(ThreadGroup const&);
+        ThreadGroup& operator=(ThreadGroup const&);
+
+        std::vector<std::thread> threads_;
+    };
+
+    /**
+     * Parses the chunks on one thread each and appends the first count
+     * polylines to arena in file order. Every chunk after the first must
+     * start where the one before it ended, the chunks that do not, because
+     * their start was a guess inside a polyline, are parsed again on the
+     * calling thread from the right place.
+     * Returns the position after the last appended polyline.
+     */
+    template <typename PointType>
+    char const* parseChunks(std::vector<PolylineChunk> const& chunks, char const* end, int count,
+                            PolylineArena<PointType>& arena)
+    {
+        const int chunkCount = chunks.size();
+        std::vector<ChunkParser<PointType> > parsers(chunkCount);
+
+        {
+            ThreadGroup threads(chunkCount);
+
+            for(int i = 0; i < chunkCount; ++i)
+            {
+                parsers[i].chunk = chunks[i];
+                parsers[i].end = end;
+                threads.start(&ChunkParser<PointType>::parse, &parsers[i]);
+            }
+        }
+
+        const std::size_t pointBase = arena.points.size();
+        const int lineBase = arena.lines.size();
+        std::vector<std::size_t> bases(chunkCount);
+        std::size_t pointCount = 0;
+        int needed = count;
+        char const* verified = chunks.empty() ? end : chunks[0].begin;
+        char const* position = verified;
+        const int dimension = sizeof(PointType) / sizeof(double);
+
+        for(int i = 0; i < chunkCount; ++i)
+        {
+            ChunkParser<PointType>& parser = parsers[i];
+
+            parser.first = lineBase + count - needed;
+            parser.used = 0;
+            bases[i] = pointBase + pointCount;
+
+            if(needed == 0)
+            {
+                continue;
+            }
+
+            if(parser.chunk.begin != verified)
+            {
+                parser.chunk.begin = verified;
+                parser.parse();
+            }
+
+            const int parsed = parser.arena.lines.size();
+
+            if(parser.error && parsed < needed)
+            {
+                std::rethrow_exception(parser.error);
+            }
+
+            parser.used = std::min(parsed, needed);
+            needed -= parser.used;
+            pointCount += parser.used == parsed ? parser.arena.points.size() : parser.arena.lines[parser.used].first;
+            verified = parser.last;
+
+            if(parser.used == parsed && parsed != 0)
+            {
+                position = parser.after;
+            }
+            else if(parser.used < parsed)
+            {
+                // Polylines after the count were parsed as well
+                position = parser.chunk.begin;
+
+                for(int j = 0; j < parser.used; ++j)
+                {
+                    position = skipPolyline(position, end, dimension);
+                }
+            }
+        }
+
+        if(needed != 0)
+        {
+            throw std::runtime_error("polyline file format not correct");
+        }
+
+        // Stitch the per thread arenas, copying them in parallel as well
+        arena.points.resize(pointBase + pointCount);
+        arena.lines.resize(lineBase + count);
+
+        ThreadGroup threads(chunkCount);
+
+        for(int i = 0; i < chunkCount; ++i)
+        {
+            threads.start(&ChunkParser<PointType>::copyTo, &parsers[i], std::ref(arena), bases[i]);
+        }
+
+        return position;
+    }
+
+    inline int defaultThreadCount(int threadCount)
+    {
+        if(threadCount <= 0)
+        {
+            threadCount = std::thread::hardware_concurrency();
+        }
+
+        return threadCount <= 0 ? 1 : threadCount;
+    }
+
+} // namespace detail
+
+/**
+ * Appends the polylines of the file that readNext() has not read yet to
+ * arena, parsing them on threadCount threads, and moves the reader past
+ * them. A threadCount of 0 uses one thread per hardware thread.
+ *
+ * The text format has no markers between polylines, so every thread
+ * starts at the first line after an even share of the bytes and takes it
+ * to be the start of a polyline. A share whose guess turns out wrong,
+ * because a polyline spans several lines, is parsed again on the calling
+ * thread, so such files are read correctly but mostly sequentially. Use
+ * the overload taking a PolylineIndex for exact boundaries.
+ * Throws std::runtime_error in case of any syntax error.
+ */
+template <typename PointType>
+void readAllParallel(MappedPolylineFile<PointType>& in, PolylineArena<PointType>& arena, int threadCount = 0)
+{
+    const int count = in.getPolylineCount() - in.getReadCount();
+    char const* const end = in.getFile().end();
+    char const* const begin = skipSpace(in.getFile().begin() + in.getPosition(), end);
+    const int chunkCount = std::min(detail::defaultThreadCount(threadCount), std::max(count, 1));
+    std::vector<PolylineChunk> chunks(chunkCount);
+
+    if(count == 0)
+    {
+        return;
+    }
+
+    for(int i = 0; i < chunkCount; ++i)
+    {
+        char const* guess = begin;
+
+        if(i > 0)
+        {
+            guess = std::find(begin + (end - begin) / chunkCount * i, end, '\n');
+            guess = skipSpace(guess, end);
+        }
+
+        chunks[i].begin = guess;
+        chunks[i].limit = count;
+
+        if(i > 0)
+        {
+            chunks[i - 1].stop = guess;
+        }
+    }
+
+    chunks.back().stop = end;
+
+    char const* const position = detail::parseChunks(chunks, end, count, arena);
+
+    in.setPosition(position - in.getFile().begin(), in.getPolylineCount());
+}
+
+/**
+ * Same as above but takes the chunk boundaries from a polyline index
+ * built for the file.
+ * Throws std::runtime_error if the index does not match the file
+ * or in case of any syntax error.
+ */
+template <typename PointType>
+void readAllParallel(MappedPolylineFile<PointType>& in, PolylineIndex const& index,
+                     PolylineArena<PointType>& arena, int threadCount = 0)
+{
+    const int polylineCount = index.getPolylineCount();
+    const int read = in.getReadCount();
+    const int count = polylineCount - read;
+    const int chunkCount = std::min(detail::defaultThreadCount(threadCount), std::max(count, 1));
+    char const* const begin = in.getFile().begin();
+    char const* const end = in.getFile().end();
+    std::vector<PolylineChunk> chunks;
+
+    if(!index.matches(in.getFile()) || polylineCount != in.getPolylineCount()
+       || (count > 0 && index.getOffset(read) != in.getPosition()))
+    {
+        throw std::runtime_error("polyline index does not match the file");
+    }
+
+    if(count == 0)
+    {
+        return;
+    }
+
+    for(int i = read; i < polylineCount; ++i)
+    {
+        const std::size_t target = in.getPosition() + (end - begin - in.getPosition()) / chunkCount * chunks.size();
+
+        if(index.getOffset(i) > static_cast<unsigned long long>(end - begin))
+        {
+            throw std::runtime_error("polyline index does not match the file");
+        }
+
+        if(chunks.empty() || index.getOffset(i) >= target)
+        {
+            PolylineChunk chunk;
+
+            chunk.begin = skipSpace(begin + index.getOffset(i), end);
+            chunk.stop = end;
+            chunk.limit = 0;
+            chunks.push_back(chunk);
+        }
+
+        ++chunks.back().limit;
+    }
+
+    char const* const position = detail::parseChunks(chunks, end, count, arena);
+
+    in.setPosition(position - begin, polylineCount);
+}
+
+} } // namespace util/simge
+
+#endif
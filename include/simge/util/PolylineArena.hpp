@@ -0,0 +1,118 @@
+/*
+ * Copyright (c) 2006 Emir UNER
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef SIMGE_UTIL_POLYLINEARENA_HPP_INCLUDED
+#define SIMGE_UTIL_POLYLINEARENA_HPP_INCLUDED
+
+#include <cstddef>
+#include <vector>
+
+#include <simge/util/Polyline.hpp>
+
+namespace simge { namespace util
+{
+
+/**
+ * Many polylines whose points are stored back to back in one vector.
+ */
+template <typename PointType>
+struct PolylineArena
+{
+    /**
+     * Location of a polyline in the points vector.
+     */
+    struct Entry
+    {
+        std::size_t first;
+        std::size_t count;
+        Color color;
+    };
+
+    typedef std::vector<PointType> PointVec;
+    typedef std::vector<Entry> EntryVec;
+
+    PointVec points;
+    EntryVec lines;
+
+    /**
+     * Count of polylines.
+     */
+    int size() const
+    {
+        return lines.size();
+    }
+
+    /**
+     * First point of the ith polyline.
+     */
+    PointType const* begin(int i) const
+    {
+        return points.empty() ? 0 : &points[0] + lines[i].first;
+    }
+
+    /**
+     * One past the last point of the ith polyline.
+     */
+    PointType const* end(int i) const
+    {
+        return begin(i) + lines[i].count;
+    }
+
+    /**
+     * Copy of the ith polyline.
+     */
+    Polyline<PointType> get(int i) const
+    {
+        Polyline<PointType> result;
+
+        result.points.assign(begin(i), end(i));
+        result.color = lines[i].color;
+
+        return result;
+    }
+
+    /**
+     * Appends the polylines of other to this one.
+     */
+    void append(PolylineArena<PointType> const& other)
+    {
+        const std::size_t offset = points.size();
+
+        points.insert(points.end(), other.points.begin(), other.points.end());
+
+        for(typename EntryVec::const_iterator it = other.lines.begin(); it != other.lines.end(); ++it)
+        {
+            lines.push_back(*it);
+            lines.back().first += offset;
+        }
+    }
+
+    void clear()
+    {
+        points.clear();
+        lines.clear();
+    }
+};
+
+} } // namespace util/simge
+
+#endif
@@ -0,0 +1,126 @@
+/*
+ * Copyright (c) 2006 Emir UNER
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef SIMGE_UTIL_POLYLINEBATCH_HPP_INCLUDED
+#define SIMGE_UTIL_POLYLINEBATCH_HPP_INCLUDED
+
+#include <cstddef>
+#include <vector>
+
+#include <simge/util/Polyline.hpp>
+#include <simge/glut/VertexBuffer.hpp>
+
+namespace simge { namespace util
+{
+
+/**
+ * Many polylines with their own colors drawn with one glMultiDrawArrays
+ * call. The points of all polylines are kept in one vertex buffer of
+ * interleaved float positions and byte colors.
+ *
+ * Appended polylines are uploaded on the next draw without touching the
+ * vertexes already uploaded. Removed polylines are skipped when drawing
+ * and their vertexes are reclaimed once they make up half of the buffer.
+ *
+ * Positions are stored relative to the first point ever appended, which
+ * is applied as a translation when drawing.
+ */
+class PolylineBatch
+{
+public:
+    PolylineBatch();
+
+    /**
+     * Adds a polyline and returns its id.
+     */
+    template <typename PointType>
+    int append(Polyline<PointType> const& line)
+    {
+        return append(line.points.empty() ? 0 : reinterpret_cast<double const*>(&line.points[0]),
+                      line.points.size(), sizeof(PointType) / sizeof(double), line.color);
+    }
+
+    /**
+     * Adds a polyline of pointCount points with dimension coordinates
+     * each and returns its id.
+     */
+    int append(double const* coordinates, std::size_t pointCount, int dimension, Color const& color);
+
+    /**
+     * Removes the polyline with the given id. The id may be returned by a
+     * later append.
+     */
+    void remove(int id);
+
+    /**
+     * Removes all polylines.
+     */
+    void clear();
+
+    /**
+     * Count of polylines.
+     */
+    int size() const
+    {
+        return size_;
+    }
+
+    /**
+     * Draws all polylines as line strips.
+     * Does not flush.
+     * Assumes that current window valid.
+     */
+    void draw();
+
+private:
+    struct Vertex
+    {
+        float position[3];
+        unsigned char color[4];
+    };
+
+    PolylineBatch(PolylineBatch const&);
+    PolylineBatch& operator=(PolylineBatch const&);
+
+    void compact();
+    void upload();
+
+    glut::VertexBuffer buffer_;
+    std::vector<Vertex> vertexes_;
+
+    // Indexed by id, removed polylines have a zero count
+    std::vector<int> firsts_;
+    std::vector<int> counts_;
+    std::vector<bool> used_;
+    std::vector<int> freeIds_;
+
+    double origin_[3];
+    bool hasOrigin_;
+    int size_;
+    std::size_t removed_;
+    std::size_t uploaded_;
+    bool reupload_;
+};
+
+} } // namespace util/simge
+
+#endif
@@ -0,0 +1,359 @@
+/*
+ * Copyright (c) 2006 Emir UNER
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef SIMGE_UTIL_POLYLINECODEC_HPP_INCLUDED
+#define SIMGE_UTIL_POLYLINECODEC_HPP_INCLUDED
+
+#include <cstddef>
+#include <iosfwd>
+#include <vector>
+#include <stdexcept>
+
+#include <simge/util/Polyline.hpp>
+
+//
+// Compact encoding of polyline points. Coordinates are rounded to integer
+// multiples of a fixed resolution, each point is stored as the difference
+// to the previous one, and the differences are zigzag mapped to unsigned
+// numbers and written as varints of 7 bits per byte. Smooth paths with
+// small steps take one or two bytes per coordinate.
+//
+// Compressed polyline files start with the 8 bytes "SIMGEDZ\0" followed by
+// the varints version, dimension and polyline count and the resolution as
+// 8 little endian bytes of its IEEE representation. Every polyline is then
+// stored as the varints point count, red, green, blue and encoded size,
+// followed by the encoded points.
+//
+
+namespace simge { namespace util
+{
+
+inline unsigned long long zigzag(long long value)
+{
+    return (static_cast<unsigned long long>(value) << 1) ^ static_cast<unsigned long long>(value >> 63);
+}
+
+inline long long unzigzag(unsigned long long value)
+{
+    return static_cast<long long>(value >> 1) ^ -static_cast<long long>(value & 1);
+}
+
+/**
+ * Writes value as a varint at out and returns the position after it.
+ * Takes at most 10 bytes.
+ */
+inline unsigned char* putVarint(unsigned char* out, unsigned long long value)
+{
+    while(value >= 0x80)
+    {
+        *out++ = static_cast<unsigned char>(value | 0x80);
+        value >>= 7;
+    }
+
+    *out++ = static_cast<unsigned char>(value);
+
+    return out;
+}
+
+/**
+ * Reads a varint at cur and advances cur past it.
+ * Returns false if the varint does not end before end.
+ */
+inline bool getVarint(unsigned char const*& cur, unsigned char const* end, unsigned long long& value)
+{
+    unsigned long long result = 0;
+    int shift = 0;
+
+    for(unsigned char const* p = cur; p != end && shift < 64; ++p, shift += 7)
+    {
+        result |= static_cast<unsigned long long>(*p & 0x7f) << shift;
+
+        if(*p < 0x80)
+        {
+            value = result;
+            cur = p + 1;
+            return true;
+        }
+    }
+
+    return false;
+}
+
+/**
+ * Appends the encoding of pointCount points of dimension coordinates each
+ * to out.
+ * Throws std::runtime_error if a coordinate is too large for the
+ * resolution.
+ */
+void encodePoints(double const* coordinates, std::size_t pointCount, int dimension,
+                  double resolution, std::vector<unsigned char>& out);
+
+/**
+ * Decodes pointCount points of dimension coordinates each from the
+ * encoding at cur to out. Returns the position after the encoding.
+ * Throws std::runtime_error if end is reached before all points are
+ * decoded or a varint is longer than 10 bytes.
+ */
+unsigned char const* decodePoints(unsigned char const* cur, unsigned char const* end, std::size_t pointCount,
+                                  int dimension, double resolution, double* out);
+
+/**
+ * A polyline whose points are kept encoded, for polylines that are rarely
+ * used. Points are rounded to the resolution.
+ */
+template <typename PointType>
+struct CompressedPolyline
+{
+    std::vector<unsigned char> data;
+    std::size_t count;
+    double resolution;
+    Color color;
+
+    CompressedPolyline()
+    : count(0), resolution(1), color(Color::black())
+    {
+    }
+};
+
+/**
+ * Compresses the points of line rounding them to the resolution.
+ * Throws std::runtime_error if a coordinate is too large for the
+ * resolution.
+ */
+template <typename PointType>
+void compress(Polyline<PointType> const& line, double resolution, CompressedPolyline<PointType>& result)
+{
+    result.data.clear();
+    result.count = line.points.size();
+    result.resolution = resolution;
+    result.color = line.color;
+
+    if(result.count != 0)
+    {
+        encodePoints(reinterpret_cast<double const*>(&line.points[0]), result.count,
+                     sizeof(PointType) / sizeof(double), resolution, result.data);
+    }
+}
+
+/**
+ * Decompresses line into result, reusing its storage.
+ * Throws std::runtime_error if the data does not hold exactly the
+ * encoding of line.count points.
+ */
+template <typename PointType>
+void decompress(CompressedPolyline<PointType> const& line, Polyline<PointType>& result)
+{
+    const std::size_t dimension = sizeof(PointType) / sizeof(double);
+    unsigned char const* const begin = line.data.data();
+    unsigned char const* const end = begin + line.data.size();
+
+    // Every coordinate takes at least one byte
+    if(line.count > line.data.size() / dimension)
+    {
+        throw std::runtime_error("compressed polyline data not correct");
+    }
+
+    result.points.resize(line.count);
+    result.color = line.color;
+
+    if(decodePoints(begin, end, line.count, dimension, line.resolution,
+                    reinterpret_cast<double*>(result.points.data())) != end)
+    {
+        throw std::runtime_error("compressed polyline data not correct");
+    }
+}
+
+/**
+ * Polyline count, dimension and resolution of a compressed polyline file.
+ */
+struct CompressedPolylineHeader
+{
+    int dimension;
+    int polylineCount;
+    double resolution;
+};
+
+/**
+ * Writes the header of a compressed polyline file.
+ * Throws std::runtime_error in case of any io error.
+ */
+void writeCompressedHeader(std::ostream& out, CompressedPolylineHeader const& header);
+
+/**
+ * Reads the header of a compressed polyline file.
+ * Throws std::runtime_error in case of any syntax/io error.
+ */
+CompressedPolylineHeader readCompressedHeader(std::istream& in);
+
+/**
+ * Writes the record of one compressed polyline.
+ * Throws std::runtime_error in case of any io error.
+ */
+void writeCompressedRecord(std::ostream& out, std::size_t pointCount, Color const& color,
+                           std::vector<unsigned char> const& data);
+
+/**
+ * Reads the record of one compressed polyline of the given dimension,
+ * reusing the storage of data.
+ * Throws std::runtime_error in case of any syntax/io error, or if the
+ * point count cannot fit in the encoded size or the encoded size is over
+ * 1 GiB.
+ */
+void readCompressedRecord(std::istream& in, int dimension, std::size_t& pointCount, Color& color,
+                          std::vector<unsigned char>& data);
+
+/**
+ * Writes a compressed polyline file. The stream must be opened in
+ * binary mode.
+ */
+template <typename PointType>
+class CompressedPolylineWriter
+{
+public:
+    /**
+     * Writes the header to the given stream. Exactly count polylines must
+     * be written afterwards.
+     * Throws std::runtime_error in case of any io error.
+     */
+    CompressedPolylineWriter(std::ostream& out, int count, double resolution)
+    : out_(out), resolution_(resolution)
+    {
+        CompressedPolylineHeader header;
+
+        header.dimension = sizeof(PointType) / sizeof(double);
+        header.polylineCount = count;
+        header.resolution = resolution;
+
+        writeCompressedHeader(out_, header);
+    }
+
+    /**
+     * Writes the polyline rounding its points to the resolution.
+     * Throws std::runtime_error in case of any io error.
+     */
+    void write(Polyline<PointType> const& line)
+    {
+        compress(line, resolution_, line_);
+        write(line_);
+    }
+
+    /**
+     * Writes an already compressed polyline, which must have the same
+     * resolution as the file.
+     * Throws std::runtime_error in case of any io error.
+     */
+    void write(CompressedPolyline<PointType> const& line)
+    {
+        if(line.resolution != resolution_)
+        {
+            throw std::runtime_error("compressed polyline resolution does not match the file");
+        }
+
+        writeCompressedRecord(out_, line.count, line.color, line.data);
+    }
+
+private:
+    std::ostream& out_;
+    double resolution_;
+    CompressedPolyline<PointType> line_;
+};
+
+/**
+ * Reads a compressed polyline file. The stream must be opened in
+ * binary mode.
+ */
+template <typename PointType>
+class CompressedPolylineFile
+{
+public:
+    /**
+     * Read data from the given stream.
+     * Throws std::runtime_error if the header is not correct or its
+     * dimension does not match PointType.
+     */
+    CompressedPolylineFile(std::istream& in)
+    : in_(in), header_(readCompressedHeader(in))
+    {
+        if(header_.dimension != static_cast<int>(sizeof(PointType) / sizeof(double)))
+        {
+            throw std::runtime_error("compressed polyline file dimension does not match");
+        }
+    }
+
+    /**
+     * Get the count of polylines.
+     */
+    int getPolylineCount() const
+    {
+        return header_.polylineCount;
+    }
+
+    /**
+     * Get the resolution of the coordinates.
+     */
+    double getResolution() const
+    {
+        return header_.resolution;
+    }
+
+    /**
+     * Return the next polyline.
+     * Throws std::runtime_error in case of any syntax/io error.
+     */
+    Polyline<PointType> getNext()
+    {
+        Polyline<PointType> result;
+
+        getNext(result);
+
+        return result;
+    }
+
+    /**
+     * Read the next polyline into result, reusing its storage.
+     * Throws std::runtime_error in case of any syntax/io error.
+     */
+    void getNext(Polyline<PointType>& result)
+    {
+        getNext(line_);
+        decompress(line_, result);
+    }
+
+    /**
+     * Read the next polyline without decoding its points.
+     * Throws std::runtime_error in case of any syntax/io error.
+     */
+    void getNext(CompressedPolyline<PointType>& result)
+    {
+        readCompressedRecord(in_, header_.dimension, result.count, result.color, result.data);
+        result.resolution = header_.resolution;
+    }
+
+private:
+    std::istream& in_;
+    CompressedPolylineHeader header_;
+    CompressedPolyline<PointType> line_;
+};
+
+} } // namespace util/simge
+
+#endif
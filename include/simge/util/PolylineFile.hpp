@@ -76,12 +76,27 @@ public:
      * Throws std::runtime_error in case of any syntax/io error.
      */
     Polyline<PointType> getNext()
+    {
+        Polyline<PointType> result;
+
+        getNext(result);
+
+        return result;
+    }
+
+    /**
+     * Read the next polyline into result, reusing the storage of its
+     * point vector.
+     * Throws std::runtime_error in case of any syntax/io error.
+     */
+    void getNext(Polyline<PointType>& result)
     {
         int pointCount;
         bool closed;
-        Polyline<PointType> result;
         char ch;
-                
+
+        result.points.clear();
+
         in_ >> pointCount;
         if(!in_.bad())
         {
@@ -132,7 +147,7 @@ public:
                         result.points.push_back(*result.points.begin());
                     }
                     
-                    return result;
+                    return;
                 }
             }
         }
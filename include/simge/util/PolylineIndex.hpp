@@ -0,0 +1,269 @@
+/*
+ * Copyright (c) 2006 Emir UNER
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef SIMGE_UTIL_POLYLINEINDEX_HPP_INCLUDED
+#define SIMGE_UTIL_POLYLINEINDEX_HPP_INCLUDED
+
+#include <cstddef>
+#include <cstdio>
+#include <memory>
+#include <vector>
+#include <algorithm>
+
+#include <simge/geom/Box.hpp>
+#include <simge/geom/LooseQuadtree.hpp>
+#include <simge/util/MappedFile.hpp>
+#include <simge/util/MappedPolylineFile.hpp>
+
+//
+// A polyline index is a sidecar file of a text polyline file. It records
+// where every polyline starts in the text file, how many points it has
+// and its bounds in the xy plane:
+//
+//   header      40 bytes, see PolylineIndexHeader
+//   entries     polylineCount PolylineIndexEntry records
+//
+// Numbers are stored in the byte order of the machine that wrote the file.
+//
+
+namespace simge { namespace util
+{
+
+struct PolylineIndexHeader
+{
+    char magic[8];
+    unsigned int byteOrder;
+    unsigned int version;
+    unsigned long long polylineCount;
+
+    // Size and modification time of the indexed text file,
+    // to detect stale indexes
+    unsigned long long fileSize;
+    unsigned long long modificationTime;
+};
+
+struct PolylineIndexEntry
+{
+    // Byte offset of the polyline in the text file
+    unsigned long long offset;
+
+    // Count of points as read, including the repeated first point
+    // of closed polylines
+    unsigned long long pointCount;
+
+    double min[2];
+    double max[2];
+};
+
+/**
+ * Reads a polyline index through a memory mapping. The entry bounds
+ * are put in a loose quadtree when the index is opened, so queries
+ * only visit the entries near the area.
+ */
+class PolylineIndex
+{
+public:
+    /**
+     * Maps the index file with the given path.
+     * Throws std::runtime_error if the file cannot be mapped or is not
+     * a polyline index written on a machine with the same byte order.
+     */
+    PolylineIndex(char const* path);
+
+    int getPolylineCount() const
+    {
+        return header_->polylineCount;
+    }
+
+    /**
+     * True if the index was built for a file of the given size
+     * and modification time.
+     */
+    bool matches(MappedFile const& file) const
+    {
+        return header_->fileSize == file.size() &&
+            header_->modificationTime == file.getModificationTime();
+    }
+
+    unsigned long long getOffset(int i) const
+    {
+        return entries_[i].offset;
+    }
+
+    std::size_t getPointCount(int i) const
+    {
+        return entries_[i].pointCount;
+    }
+
+    geom::Box<2> getBounds(int i) const
+    {
+        return geom::Box<2>(geom::point(entries_[i].min[0], entries_[i].min[1]),
+                            geom::point(entries_[i].max[0], entries_[i].max[1]));
+    }
+
+    /**
+     * Fills the given collection with the indexes of the polylines
+     * whose bounds intersect area, in file order.
+     */
+    template <typename Collection>
+    void query(geom::Box<2> const& area, Collection& ids) const
+    {
+        std::vector<int> found;
+
+        if(tree_.get() == 0)
+        {
+            return;
+        }
+
+        tree_->query(area, found);
+
+        // Reading in file order keeps the access to the text file sequential
+        for(std::vector<int>::iterator it = found.begin(); it != found.end(); ++it)
+        {
+            *it = polylines_[*it];
+        }
+
+        std::sort(found.begin(), found.end());
+
+        for(std::vector<int>::const_iterator it = found.begin(); it != found.end(); ++it)
+        {
+            ids.push_back(*it);
+        }
+    }
+
+private:
+    // Not copyable.
+    PolylineIndex(PolylineIndex const&);
+    PolylineIndex& operator=(PolylineIndex const&);
+
+    void buildTree();
+
+    MappedFile file_;
+    PolylineIndexHeader const* header_;
+    PolylineIndexEntry const* entries_;
+
+    // Bounds of the polylines with points, empty polylines are left out.
+    // Null if there are none.
+    std::unique_ptr<geom::LooseQuadtree> tree_;
+
+    // Polyline index of every object in the tree, by object id. The tree
+    // hands out ids from 0 up when nothing is removed.
+    std::vector<int> polylines_;
+};
+
+/**
+ * Writes a polyline index, one entry at a time.
+ */
+class PolylineIndexWriter
+{
+public:
+    /**
+     * Creates the index file with the given path for a text
+     * file of the given size and modification time.
+     * Throws std::runtime_error if the file cannot be created.
+     */
+    PolylineIndexWriter(char const* path, unsigned long long fileSize, unsigned long long modificationTime);
+
+    /**
+     * Closes the file if close() was not called. Errors are ignored.
+     */
+    ~PolylineIndexWriter();
+
+    /**
+     * Adds the entry of the next polyline.
+     * Throws std::runtime_error on write errors.
+     */
+    void add(unsigned long long offset, std::size_t pointCount, geom::Box<2> const& bounds);
+
+    /**
+     * Writes the header and closes the file.
+     * Throws std::runtime_error on write errors.
+     */
+    void close();
+
+private:
+    // Not copyable.
+    PolylineIndexWriter(PolylineIndexWriter const&);
+    PolylineIndexWriter& operator=(PolylineIndexWriter const&);
+
+    std::FILE* out_;
+    unsigned long long count_;
+    unsigned long long fileSize_;
+    unsigned long long modificationTime_;
+    bool failed_;
+};
+
+/**
+ * Builds the index of a text polyline file.
+ */
+template <typename PointType>
+void buildPolylineIndex(char const* textPath, char const* indexPath)
+{
+    MappedPolylineFile<PointType> in(textPath);
+    PolylineIndexWriter out(indexPath, in.getFile().size(), in.getFile().getModificationTime());
+    PolylineArena<PointType> arena;
+    unsigned long long offset = in.getPosition();
+
+    while(in.readNext(arena))
+    {
+        geom::Box<2> bounds;
+
+        for(PointType const* p = arena.begin(0); p != arena.end(0); ++p)
+        {
+            bounds.extend(geom::Point<2>(*p));
+        }
+
+        out.add(offset, arena.lines[0].count, bounds);
+        offset = in.getPosition();
+        arena.clear();
+    }
+
+    out.close();
+}
+
+/**
+ * Appends the polylines of in whose bounds intersect area to arena.
+ * Throws std::runtime_error if the index does not match the file
+ * or in case of any syntax error.
+ */
+template <typename PointType>
+void readVisible(MappedPolylineFile<PointType>& in, PolylineIndex const& index,
+                 geom::Box<2> const& area, PolylineArena<PointType>& arena)
+{
+    std::vector<int> ids;
+
+    if(!index.matches(in.getFile()))
+    {
+        throw std::runtime_error("polyline index does not match the file");
+    }
+
+    index.query(area, ids);
+
+    for(std::vector<int>::const_iterator it = ids.begin(); it != ids.end(); ++it)
+    {
+        in.readAt(index.getOffset(*it), arena);
+    }
+}
+
+} } // namespace util/simge
+
+#endif
@@ -0,0 +1,139 @@
+/*
+ * Copyright (c) 2006 Emir UNER
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef SIMGE_UTIL_POLYLINERENDERER_HPP_INCLUDED
+#define SIMGE_UTIL_POLYLINERENDERER_HPP_INCLUDED
+
+#include <vector>
+
+#include <simge/util/Polyline.hpp>
+#include <simge/glut/VertexBuffer.hpp>
+
+namespace simge { namespace util
+{
+
+/**
+ * Draws a polyline from a vertex buffer with a single glDrawArrays call.
+ * The points are uploaded on the first draw and again only after the
+ * polyline changed.
+ *
+ * Points are uploaded as floats relative to the first point, which is
+ * applied as a translation when drawing, so that large coordinates keep
+ * their precision near the polyline.
+ */
+template <typename PointType>
+class PolylineRenderer
+{
+public:
+    /**
+     * A renderer for the given polyline, which must outlive it.
+     */
+    explicit PolylineRenderer(Polyline<PointType> const& line)
+    : line_(line), data_(0), count_(0), dirty_(true)
+    {
+    }
+
+    /**
+     * Marks the points as changed. Changes of the point count or the
+     * point storage are detected without it.
+     */
+    void invalidate()
+    {
+        dirty_ = true;
+    }
+
+    /**
+     * Draws the polyline as a line strip.
+     * Does not flush.
+     * Assumes that current window valid.
+     */
+    void draw()
+    {
+        const int dimension = sizeof(PointType) / sizeof(double);
+
+        if(line_.points.empty())
+        {
+            return;
+        }
+
+        if(dirty_ || count_ != line_.points.size() || data_ != &line_.points[0])
+        {
+            upload();
+        }
+
+        color(line_.color);
+
+        glPushMatrix();
+        glTranslated(origin_[0], origin_[1], dimension > 2 ? origin_[2] : 0);
+
+        glPushClientAttrib(GL_CLIENT_VERTEX_ARRAY_BIT);
+        glEnableClientState(GL_VERTEX_ARRAY);
+        buffer_.bind();
+        glVertexPointer(dimension, GL_FLOAT, 0, buffer_.getPointer(0));
+        glDrawArrays(GL_LINE_STRIP, 0, count_);
+        buffer_.unbind();
+        glPopClientAttrib();
+
+        glPopMatrix();
+    }
+
+private:
+    PolylineRenderer(PolylineRenderer const&);
+    PolylineRenderer& operator=(PolylineRenderer const&);
+
+    void upload()
+    {
+        const int dimension = sizeof(PointType) / sizeof(double);
+        typename Polyline<PointType>::PointVec const& points = line_.points;
+
+        origin_ = points[0];
+        floats_.resize(points.size() * dimension);
+
+        std::vector<float>::iterator out = floats_.begin();
+
+        for(typename Polyline<PointType>::PointVec::const_iterator it = points.begin(); it != points.end(); ++it)
+        {
+            for(int i = 0; i < dimension; ++i, ++out)
+            {
+                *out = static_cast<float>((*it)[i] - origin_[i]);
+            }
+        }
+
+        buffer_.upload(&floats_[0], floats_.size() * sizeof(float));
+
+        data_ = &points[0];
+        count_ = points.size();
+        dirty_ = false;
+    }
+
+    Polyline<PointType> const& line_;
+    glut::VertexBuffer buffer_;
+    std::vector<float> floats_;
+    PointType origin_;
+    PointType const* data_;
+    std::size_t count_;
+    bool dirty_;
+};
+
+} } // namespace util/simge
+
+#endif
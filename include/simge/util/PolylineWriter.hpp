@@ -0,0 +1,192 @@
+/*
+ * Copyright (c) 2006 Emir UNER
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef SIMGE_UTIL_POLYLINEWRITER_HPP_INCLUDED
+#define SIMGE_UTIL_POLYLINEWRITER_HPP_INCLUDED
+
+#include <cmath>
+#include <ostream>
+#include <vector>
+#include <stdexcept>
+
+#include <simge/util/Polyline.hpp>
+#include <simge/util/Format.hpp>
+
+namespace simge { namespace util
+{
+
+/**
+ * Writes a polyline file in the format read by PolylineFile. Numbers are
+ * written in the shortest form that reads back to the same value and
+ * collected in a large buffer before being passed to the stream.
+ */
+template <typename PointType>
+class PolylineWriter
+{
+public:
+    /**
+     * Writes the polyline count to the given stream. Exactly count
+     * polylines must be written afterwards.
+     */
+    PolylineWriter(std::ostream& out, int count, std::size_t bufferSize = 1 << 20)
+    : out_(out), buffer_(bufferSize < kMaxLineChars ? kMaxLineChars : bufferSize), cur_(&buffer_[0])
+    {
+        cur_ = formatInt(cur_, count);
+        *cur_++ = '\n';
+    }
+
+    /**
+     * Flushes the buffer, ignoring errors. Use close() to detect them.
+     */
+    ~PolylineWriter()
+    {
+        try
+        {
+            flush();
+        }
+        catch(...)
+        {
+        }
+    }
+
+    /**
+     * Writes an open polyline.
+     * Throws std::runtime_error if a coordinate is not finite or in case
+     * of any io error.
+     */
+    void write(Polyline<PointType> const& line)
+    {
+        if(!line.points.empty())
+        {
+            write(&line.points[0], &line.points[0] + line.points.size(), line.color);
+        }
+        else
+        {
+            write(static_cast<PointType const*>(0), static_cast<PointType const*>(0), line.color);
+        }
+    }
+
+    /**
+     * Writes the points [begin, end) as one polyline. If closed is true the
+     * last point must be the same as the first one, and it is written as
+     * a closed polyline without the last point.
+     * Throws std::runtime_error in case of any io error, or if a coordinate
+     * is not finite, which the readers reject. Nothing of the polyline is
+     * written in that case.
+     */
+    void write(PointType const* begin, PointType const* end, Color const& color, bool closed = false)
+    {
+        const int dimension = sizeof(PointType) / sizeof(double);
+        int count = end - begin;
+
+        for(PointType const* p = begin; p != end; ++p)
+        {
+            for(int i = 0; i < dimension; ++i)
+            {
+                if(!std::isfinite((*p)[i]))
+                {
+                    throw std::runtime_error("polyline coordinate is not finite");
+                }
+            }
+        }
+
+        if(closed && count > 0)
+        {
+            --end;
+            --count;
+        }
+
+        reserve(kMaxIntChars + kMaxColorChars + 2);
+        cur_ = formatInt(cur_, closed ? -count : count);
+
+        // Points default to black when read, so black is not written
+        if(color != Color::black())
+        {
+            *cur_++ = ' ';
+            cur_ = formatColor(cur_, color);
+        }
+
+        *cur_++ = '\n';
+
+        for(; begin != end; ++begin)
+        {
+            reserve(kMaxLineChars);
+
+            for(int i = 0; i < dimension; ++i)
+            {
+                cur_ = formatDouble(cur_, (*begin)[i]);
+                *cur_++ = ' ';
+            }
+
+            cur_[-1] = '\n';
+        }
+    }
+
+    /**
+     * Passes the buffered characters to the stream and flushes it.
+     * Throws std::runtime_error in case of any io error.
+     */
+    void close()
+    {
+        flush();
+        out_.flush();
+
+        if(!out_)
+        {
+            throw std::runtime_error("polyline file error while writing");
+        }
+    }
+
+private:
+    // One point of at most three coordinates and their separators
+    static const std::size_t kMaxLineChars = 3 * (kMaxDoubleChars + 1);
+
+    PolylineWriter(PolylineWriter const&);
+    PolylineWriter& operator=(PolylineWriter const&);
+
+    void reserve(std::size_t count)
+    {
+        if(static_cast<std::size_t>(&buffer_[0] + buffer_.size() - cur_) < count)
+        {
+            flush();
+        }
+    }
+
+    void flush()
+    {
+        out_.write(&buffer_[0], cur_ - &buffer_[0]);
+        cur_ = &buffer_[0];
+
+        if(!out_)
+        {
+            throw std::runtime_error("polyline file error while writing");
+        }
+    }
+
+    std::ostream& out_;
+    std::vector<char> buffer_;
+    char* cur_;
+};
+
+} } // namespace util/simge
+
+#endif
@@ -0,0 +1,126 @@
+/*
+ * Copyright (c) 2006 Emir UNER
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef SIMGE_UTIL_SCAN_HPP_INCLUDED
+#define SIMGE_UTIL_SCAN_HPP_INCLUDED
+
+//
+// Scanning of numbers from character buffers that are not null terminated.
+// Every function starts at cur, skips leading white space, and on success
+// advances cur past the scanned token.
+//
+
+#include <climits>
+
+namespace simge { namespace util
+{
+
+inline bool isSpace(char ch)
+{
+    return ch == ' ' || ch == '\n' || ch == '\t' || ch == '\r' || ch == '\v' || ch == '\f';
+}
+
+inline bool isDigit(char ch)
+{
+    return ch >= '0' && ch <= '9';
+}
+
+/**
+ * Returns the first position at or after cur that is not white space.
+ */
+inline char const* skipSpace(char const* cur, char const* end)
+{
+    while(cur != end && isSpace(*cur))
+    {
+        ++cur;
+    }
+
+    return cur;
+}
+
+/**
+ * Returns the first white space position at or after cur.
+ */
+inline char const* skipToken(char const* cur, char const* end)
+{
+    while(cur != end && !isSpace(*cur))
+    {
+        ++cur;
+    }
+
+    return cur;
+}
+
+/**
+ * Scans a decimal integer with an optional sign.
+ * Fails if the number does not fit in an int.
+ */
+inline bool scanInt(char const*& cur, char const* end, int& value)
+{
+    char const* p = skipSpace(cur, end);
+    bool negative = false;
+
+    if(p != end && (*p == '-' || *p == '+'))
+    {
+        negative = *p == '-';
+        ++p;
+    }
+
+    if(p == end || !isDigit(*p))
+    {
+        return false;
+    }
+
+    // The magnitude is accumulated unsigned so that INT_MIN fits
+    const unsigned int limit = negative ? static_cast<unsigned int>(INT_MAX) + 1 : INT_MAX;
+    unsigned int result = 0;
+
+    while(p != end && isDigit(*p))
+    {
+        const unsigned int digit = *p - '0';
+
+        if(result > (limit - digit) / 10)
+        {
+            return false;
+        }
+
+        result = result * 10 + digit;
+        ++p;
+    }
+
+    value = negative && result > 0 ? -static_cast<int>(result - 1) - 1 : static_cast<int>(result);
+    cur = p;
+
+    return true;
+}
+
+/**
+ * Scans a floating point number in the format accepted by strtod, except
+ * for hexadecimal numbers, infinities and NaNs. Numbers whose significant
+ * digits fit in 53 bits and whose decimal exponent is at most 22 are
+ * converted without strtod, the rest fall back to it.
+ */
+bool scanDouble(char const*& cur, char const* end, double& value);
+
+} } // namespace util/simge
+
+#endif
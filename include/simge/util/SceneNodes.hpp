@@ -0,0 +1,168 @@
+/*
+ * Copyright (c) 2006 Emir UNER
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef SIMGE_UTIL_SCENENODES_HPP_INCLUDED
+#define SIMGE_UTIL_SCENENODES_HPP_INCLUDED
+
+#include <string>
+
+#include <simge/glut/Scene.hpp>
+#include <simge/util/Polyline.hpp>
+#include <simge/util/Color.hpp>
+#include <simge/geom/Polygon.hpp>
+
+namespace simge { namespace util
+{
+
+/**
+ * A polyline drawn as a line strip.
+ */
+template <typename PointType>
+class PolylineNode : public glut::SceneNode
+{
+public:
+    explicit PolylineNode(Polyline<PointType> const& line)
+    : line_(line)
+    {
+    }
+
+    Polyline<PointType> const& getPolyline() const
+    {
+        return line_;
+    }
+
+    void setPolyline(Polyline<PointType> const& line)
+    {
+        line_ = line;
+        markDirty();
+    }
+
+    /**
+     * Bounds of the points projected to the x, y plane.
+     */
+    geom::Box<2> getBounds() const
+    {
+        geom::Box<2> bounds;
+
+        for(typename Polyline<PointType>::PointVec::const_iterator it = line_.points.begin();
+            it != line_.points.end(); ++it)
+        {
+            bounds.extend(geom::point((*it)[0], (*it)[1]));
+        }
+
+        return bounds;
+    }
+
+protected:
+    void render()
+    {
+        util::draw(line_);
+    }
+
+private:
+    Polyline<PointType> line_;
+};
+
+/**
+ * The border of a polygon drawn as a line loop.
+ */
+class PolygonNode : public glut::SceneNode
+{
+public:
+    PolygonNode(geom::Polygon<2> const& polygon, Color const& color);
+
+    geom::Polygon<2> const& getPolygon() const
+    {
+        return polygon_;
+    }
+
+    void setPolygon(geom::Polygon<2> const& polygon);
+
+    void setColor(Color const& color);
+
+    geom::Box<2> getBounds() const;
+
+protected:
+    void render();
+
+private:
+    geom::Polygon<2> polygon_;
+    Color color_;
+};
+
+/**
+ * A circle approximated by an n-gon, see drawCircle.
+ */
+class CircleNode : public glut::SceneNode
+{
+public:
+    CircleNode(geom::Point<2> const& center, double radius, Color const& color, int approx = 40);
+
+    void setCircle(geom::Point<2> const& center, double radius);
+
+    void setColor(Color const& color);
+
+    geom::Box<2> getBounds() const;
+
+protected:
+    void render();
+
+private:
+    geom::Point<2> center_;
+    double radius_;
+    Color color_;
+    int approx_;
+};
+
+/**
+ * A string written with a GLUT bitmap font, see drawText. Its size is in
+ * pixels, so it has no bounds and is never culled. The glyph lists are
+ * built before the node is compiled, and the start is a raster position,
+ * so the string follows view changes and is not drawn when the start is
+ * outside of the viewport.
+ */
+class TextNode : public glut::SceneNode
+{
+public:
+    TextNode(void* font, geom::Point<2> const& pos, char const* text, Color const& color);
+
+    void setText(char const* text);
+
+    void setPosition(geom::Point<2> const& pos);
+
+    void setColor(Color const& color);
+
+protected:
+    void prepare();
+
+    void render();
+
+private:
+    void* font_;
+    geom::Point<2> pos_;
+    std::string text_;
+    Color color_;
+};
+
+} } // namespace util/simge
+
+#endif
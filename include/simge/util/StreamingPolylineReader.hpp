@@ -0,0 +1,218 @@
+/*
+ * Copyright (c) 2006 Emir UNER
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef SIMGE_UTIL_STREAMINGPOLYLINEREADER_HPP_INCLUDED
+#define SIMGE_UTIL_STREAMINGPOLYLINEREADER_HPP_INCLUDED
+
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <exception>
+#include <stdexcept>
+
+#include <simge/util/PolylineFile.hpp>
+
+namespace simge { namespace util
+{
+
+/**
+ * Reads a polyline file on a background thread into a fixed ring of
+ * reusable Polyline buffers. Polylines are handed out with lease() and
+ * must be handed back with giveBack() so that their buffers can be
+ * filled again. Once the buffers have grown to the size of the largest
+ * polylines no more allocations take place.
+ *
+ * At most bufferCount polylines are held in memory at any time, those
+ * read ahead plus those leased.
+ */
+template <typename PointType>
+class StreamingPolylineReader
+{
+public:
+    typedef Polyline<PointType> PolylineType;
+
+    /**
+     * Starts reading from the given stream, which must stay valid
+     * during the lifetime of the reader.
+     * Throws std::runtime_error if the polyline count cannot be read.
+     */
+    StreamingPolylineReader(std::istream& in, int bufferCount = 16)
+    : file_(in), buffers_(bufferCount < 1 ? 1 : bufferCount), ready_(buffers_.size()),
+      head_(0), readyCount_(0), stop_(false), done_(false)
+    {
+        free_.reserve(buffers_.size());
+
+        for(typename BufferVec::iterator it = buffers_.begin(); it != buffers_.end(); ++it)
+        {
+            free_.push_back(&*it);
+        }
+
+        thread_ = std::thread(&StreamingPolylineReader::run, this);
+    }
+
+    /**
+     * Stops the background thread. Leased polylines become invalid.
+     */
+    ~StreamingPolylineReader()
+    {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            stop_ = true;
+        }
+
+        changed_.notify_all();
+        thread_.join();
+    }
+
+    /**
+     * Get the count of polylines.
+     */
+    int getPolylineCount() const
+    {
+        return file_.getPolylineCount();
+    }
+
+    /**
+     * Returns the next polyline in file order, waiting for it to be read
+     * if necessary, or 0 after the last one. The polyline stays valid
+     * until it is handed back.
+     * Throws std::runtime_error in case of any syntax/io error.
+     */
+    PolylineType* lease()
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+
+        while(readyCount_ == 0 && !done_)
+        {
+            changed_.wait(lock);
+        }
+
+        if(readyCount_ == 0)
+        {
+            if(error_)
+            {
+                std::rethrow_exception(error_);
+            }
+
+            return 0;
+        }
+
+        PolylineType* line = ready_[head_];
+
+        head_ = (head_ + 1) % ready_.size();
+        --readyCount_;
+
+        return line;
+    }
+
+    /**
+     * Hands back a polyline returned by lease() so that its buffer
+     * can be reused.
+     */
+    void giveBack(PolylineType* line)
+    {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            free_.push_back(line);
+        }
+
+        changed_.notify_all();
+    }
+
+private:
+    typedef std::vector<PolylineType> BufferVec;
+
+    StreamingPolylineReader(StreamingPolylineReader const&);
+    StreamingPolylineReader& operator=(StreamingPolylineReader const&);
+
+    void run()
+    {
+        const int count = file_.getPolylineCount();
+
+        for(int i = 0; i < count; ++i)
+        {
+            PolylineType* line;
+
+            {
+                std::unique_lock<std::mutex> lock(mutex_);
+
+                while(free_.empty() && !stop_)
+                {
+                    changed_.wait(lock);
+                }
+
+                if(stop_)
+                {
+                    return;
+                }
+
+                line = free_.back();
+                free_.pop_back();
+            }
+
+            // Parse outside the lock so that the consumer is not blocked
+            try
+            {
+                file_.getNext(*line);
+            }
+            catch(...)
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                error_ = std::current_exception();
+                break;
+            }
+
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                ready_[(head_ + readyCount_) % ready_.size()] = line;
+                ++readyCount_;
+            }
+
+            changed_.notify_all();
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            done_ = true;
+        }
+
+        changed_.notify_all();
+    }
+
+    PolylineFile<PointType> file_;
+    BufferVec buffers_;
+    std::vector<PolylineType*> free_;
+    std::vector<PolylineType*> ready_;
+    std::size_t head_;
+    std::size_t readyCount_;
+    bool stop_;
+    bool done_;
+    std::exception_ptr error_;
+    std::mutex mutex_;
+    std::condition_variable changed_;
+    std::thread thread_;
+};
+
+} } // namespace util/simge
+
+#endif
@@ -0,0 +1,169 @@
+/*
+ * Copyright (c) 2006 Emir UNER
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef SIMGE_UTIL_TEXTRENDERER_HPP_INCLUDED
+#define SIMGE_UTIL_TEXTRENDERER_HPP_INCLUDED
+
+#include <GL/glut.h>
+#include <vector>
+
+#include <simge/geom/Point.hpp>
+
+namespace simge { namespace util {
+
+/**
+ * Compiles every glyph of a GLUT bitmap font into a display list once, so
+ * that a string is drawn with one glRasterPos and one glCallLists call.
+ * Each glyph list also advances the raster position by its width.
+ *
+ * draw() may be compiled into a display list, such as a SceneNode's, and
+ * the raster position is transformed when the list is called. As with
+ * glRasterPos, a string whose start is outside of the viewport is not
+ * drawn, see TextBatch for labels that may start off screen.
+ *
+ * The lists belong to the window that is current when they are built, so
+ * the cache must be used and destroyed with that window current. They
+ * cannot be built while another list is compiled, call build() before.
+ */
+class GlyphCache
+{
+public:
+    explicit GlyphCache(void* font);
+
+    /**
+     * Deletes the glyph lists.
+     */
+    ~GlyphCache();
+
+    /**
+     * Compiles the glyph lists if they are not compiled yet. Must not be
+     * called while a display list is compiled, the first draw() builds
+     * the lists otherwise.
+     */
+    void build();
+
+    /**
+     * Forgets the glyph lists without deleting them, for when their
+     * window is already gone. They are built again on the next draw.
+     */
+    void abandon();
+
+    /**
+     * Writes len characters of str starting at pos.
+     * Assumes that current window valid.
+     */
+    void draw(geom::Point<3> const& pos, char const* str, int len);
+
+    void draw(geom::Point<2> const& pos, char const* str, int len)
+    {
+        draw(geom::Point<3>(pos), str, len);
+    }
+
+    /**
+     * Writes the null terminated str starting at pos.
+     * Assumes that current window valid.
+     */
+    void draw(geom::Point<3> const& pos, char const* str);
+
+    void draw(geom::Point<2> const& pos, char const* str)
+    {
+        draw(geom::Point<3>(pos), str);
+    }
+
+    /**
+     * Width of the string in pixels.
+     */
+    int getWidth(char const* str, int len);
+
+    void* getFont() const
+    {
+        return font_;
+    }
+
+private:
+    friend class TextBatch;
+
+    GlyphCache(GlyphCache const&);
+    GlyphCache& operator=(GlyphCache const&);
+
+    void loadWidths();
+
+    void* font_;
+    GLuint base_;
+    std::vector<int> widths_;
+};
+
+/**
+ * The glyph cache of font for the current window. Created and built on
+ * first use, so the first call must not be made while a display list is
+ * compiled. The caches of a glut::Window are dropped when it is destroyed.
+ */
+GlyphCache& glyphCache(void* font);
+
+/**
+ * Labels collected during a frame and drawn together with the glyph
+ * lists of one cache. The label starts are projected on the CPU with one
+ * read of the matrices per draw and set with glWindowPos, so a label
+ * starting outside of the viewport is still drawn in part. Labels
+ * starting in front of the near or behind the far plane are not drawn.
+ * The storage is kept between frames.
+ *
+ * Since the positions are computed when draw() is called, it must not be
+ * compiled into a display list.
+ */
+class TextBatch
+{
+public:
+    explicit TextBatch(GlyphCache& cache);
+
+    /**
+     * Adds a label at pos.
+     */
+    void add(geom::Point<2> const& pos, char const* str);
+
+    /**
+     * Removes all labels.
+     */
+    void clear();
+
+    /**
+     * Writes all labels.
+     * Assumes that current window valid.
+     */
+    void draw();
+
+private:
+    struct Label
+    {
+        geom::Point<2> pos;
+        int first;
+        int count;
+    };
+
+    GlyphCache& cache_;
+    std::vector<char> chars_;
+    std::vector<Label> labels_;
+};
+
+} } // namespace util/simge
+
+#endif
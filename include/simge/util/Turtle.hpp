@@ -24,12 +24,20 @@
 #define SIMGE_UTIL_TURTLE_HPP_INCLUDED
 
 #include <simge/glut/Point.hpp>
+#include <simge/geom/Vector.hpp>
 #include <simge/util/Color.hpp>
+#include <simge/util/Polyline.hpp>
+
+#include <vector>
 
 namespace simge { namespace util {
 
 /**
- * A turtle that paints onto a window.
+ * A turtle that paints onto a window. Lines drawn immediately use the
+ * current OpenGL color.
+ *
+ * In recording mode lines are not drawn immediately but appended with the
+ * tail color to a path buffer, which flush() draws with a single call.
  */
 class Turtle
 {
@@ -48,6 +56,14 @@ public:
      * Change tail color.
      */
     void setTailColor(Color const& color);
+
+    /**
+     * Get tail color.
+     */
+    inline Color const& getTailColor() const
+    {
+        return tail_;
+    }
     
     /**
      * Jump to a location.
@@ -91,11 +107,75 @@ public:
     {
         return pos_;
     }
+
+    /**
+     * Get current direction of the turtle in degrees.
+     */
+    inline double getAngle() const
+    {
+        return angle_;
+    }
+
+    /**
+     * Switches recording mode on or off. Switching it off does not
+     * discard the recorded lines.
+     */
+    void setRecording(bool recording);
+
+    inline bool isRecording() const
+    {
+        return recording_;
+    }
+
+    /**
+     * Count of recorded line segments.
+     */
+    inline std::size_t getSegmentCount() const
+    {
+        return vertexes_.size() / 4;
+    }
+
+    /**
+     * Draws the recorded lines as GL_LINES with one draw call and
+     * discards them. The current color and client arrays are restored.
+     * Does not flush OpenGL.
+     * Assumes that current window valid.
+     */
+    void flush();
+
+    /**
+     * Discards the recorded lines without drawing them.
+     */
+    void clearRecording();
+
+    /**
+     * Appends the recorded lines to lines, joining segments that continue
+     * each other with the same color into one polyline.
+     */
+    void exportPolylines(std::vector<Polyline<geom::Point<2> > >& lines) const;
+
+    /**
+     * Rotates the recorded lines by angle degrees around (0, 0) and then
+     * moves them by offset.
+     */
+    void transformRecording(geom::Vector<2> const& offset, double angle);
+
+    /**
+     * Appends the lines recorded by other to the recorded lines.
+     */
+    void appendRecording(Turtle const& other);
     
 private:
+    void segment(geom::Point<2> const& from, geom::Point<2> const& to);
+
     Color tail_;
     double angle_;
     geom::Point<2> pos_;
+    bool recording_;
+
+    // Two x, y pairs and two r, g, b triples per segment
+    std::vector<double> vertexes_;
+    std::vector<GLushort> colors_;
 };
 
 } } // namespace glut/simge
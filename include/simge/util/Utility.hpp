@@ -28,6 +28,7 @@
 #include <simge/glut/Point.hpp>
 #include <simge/geom/Polygon.hpp>
 #include <simge/geom/Edge.hpp>
+#include <simge/util/TextRenderer.hpp>
 
 #include <algorithm>
 
@@ -47,10 +48,19 @@ void drawCross(geom::Point<2> const& pos, int size);
 /**
  * Draw circle at the given position and radius.
  * This function approximates the circle by n-gons.
- * The approx parameter specify n.
+ * The approx parameter specify n, nothing is drawn if it is not positive.
  */
 void drawCircle(geom::Point<2> const& center, double radius, int approx = 40);
 
+/**
+ * Draws count circles with one draw call. The n-gon of every circle is
+ * chosen so that it stays within half a pixel of the circle, scale being
+ * the pixels per unit length. If scale is not positive all circles use
+ * approx instead, and nothing is drawn if approx is not positive either.
+ */
+void drawCircles(geom::Point<2> const* centers, double const* radii, int count,
+                 double scale = 0, int approx = 40);
+
 /**
  * Draws a simple grab handle with red border and green fill.
  */
@@ -87,21 +97,14 @@ void drawEdge(geom::Edge<Dim> const& ls)
 }
 
 /**
- * Writes a string to the current window.
+ * Writes a string to the current window with the glyph cache of font,
+ * see glyphCache().
  */
 template <typename PointType>
-void drawText(void* font, PointType pos, char const* str)
+void drawText(void* font, PointType const& pos, char const* str)
 {
-    glut::rasterPos(pos);
-    
-    while(*str != '\0')
-    {
-        glutBitmapCharacter(font, *str);
-        pos[0] += glutBitmapWidth(font, *str);
-        glut::rasterPos(pos);
-        ++str;
-    }
-}    
+    glyphCache(font).draw(pos, str);
+}
 
 } } // namespace util/simge
 
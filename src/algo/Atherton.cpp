@@ -25,6 +25,7 @@
 
 #include <simge/algo/Atherton.hpp>
 #include <simge/geom/Edge.hpp>
+#include <simge/geom/Weld.hpp>
 
 using namespace simge::geom;
 
@@ -34,6 +35,14 @@ namespace
 struct Vertex;
 typedef std::list<Vertex> Vertexes;
 
+// Both copies of an intersection vertex are created from the same point,
+// a grid as fine as the tolerance of Point's operator== pairs them.
+const double kWeldGrid = 0.00000001;
+
+// Several intersection vertexes may share a position,
+// they are kept in list order
+typedef std::unordered_map<GridKey<2>, std::vector<Vertexes::iterator>, GridKeyHash<2> > VertexIndex;
+
 struct Vertex
 {
     Point<2> pos;
@@ -164,14 +173,56 @@ void markIntersections(Vertexes& a, Vertexes& b)
     mergeIntersection(a, aints);
     mergeIntersection(b, bints);
 
+    // Pairs the vertexes in the same order as comparing every vertex
+    // of a with every vertex of b, so the last match wins on both sides.
+    // Positions out of grid range are compared that way.
+    VertexIndex bindex;
+    std::vector<Vertexes::iterator> bfar;
+
+    for(Vertexes::iterator j = b.begin(), end = b.end(); j != end; ++j)
+    {
+        if(isInx(j))
+        {
+            if(isInGridRange(j->pos, kWeldGrid))
+            {
+                bindex[gridKey(j->pos, kWeldGrid)].push_back(j);
+            }
+            else
+            {
+                bfar.push_back(j);
+            }
+        }
+    }
+
     for(Vertexes::iterator i = a.begin(), end = a.end(); i != end; ++i)
     {
-        for(Vertexes::iterator j = b.begin(), end = b.end(); j != end; ++j)
+        if(!isInx(i))
         {
-            if(i->pos == j->pos && isInx(i) && isInx(j))
+            continue;
+        }
+
+        if(isInGridRange(i->pos, kWeldGrid))
+        {
+            VertexIndex::iterator found = bindex.find(gridKey(i->pos, kWeldGrid));
+
+            if(found != bindex.end())
             {
-                i->other = j;
-                j->other = i;
+                for(std::vector<Vertexes::iterator>::iterator j = found->second.begin(); j != found->second.end(); ++j)
+                {
+                    i->other = *j;
+                    (*j)->other = i;
+                }
+            }
+        }
+        else
+        {
+            for(std::vector<Vertexes::iterator>::iterator j = bfar.begin(); j != bfar.end(); ++j)
+            {
+                if(i->pos == (*j)->pos)
+                {
+                    i->other = *j;
+                    (*j)->other = i;
+                }
             }
         }
     }
@@ -279,6 +330,12 @@ std::vector<Polygon<2> > atherton(Polygon<2> const& subjp, Polygon<2> const& cli
 {
     Vertexes subject, clip, entering;
     std::vector<Polygon<2> > polys;
+
+    // Polygons with disjoint bounds have no intersection vertexes
+    if(!subjp.getBounds().intersects(clipp.getBounds()))
+    {
+        return polys;
+    }
     
     polygonToVertexes(subjp, subject);
     polygonToVertexes(clipp, clip);
@@ -37,6 +37,11 @@ bool isInsidePolygon(Polygon<2> const& poly, Point<2> const& q)
     const int polySides = poly.size();
     bool oddNodes = false;
     PointVec v;
+
+    if(!poly.getBounds().contains(q))
+    {
+        return false;
+    }
     
     for(Polygon<2>::const_iterator it = poly.begin(); it != poly.end(); ++it)    
     {
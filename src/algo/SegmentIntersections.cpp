@@ -0,0 +1,480 @@
+/*
+ * Copyright (c) 2006 Emir UNER
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <set>
+#include <algorithm>
+#include <vector>
+#include <utility>
+#include <math.h>
+
+#include <simge/algo/SegmentIntersections.hpp>
+
+using namespace simge::geom;
+
+namespace
+{
+    const double kEpsilon = 0.00000001;
+
+    /**
+     * Exact lexicographic order of points, the order the sweep visits them.
+     */
+    inline bool sweepsBefore(Point<2> const& lhs, Point<2> const& rhs)
+    {
+        return lhs[0] < rhs[0] || (lhs[0] == rhs[0] && lhs[1] < rhs[1]);
+    }
+
+    struct PointLess
+    {
+        bool operator()(Point<2> const& lhs, Point<2> const& rhs) const
+        {
+            return sweepsBefore(lhs, rhs);
+        }
+    };
+
+    /**
+     * An edge with its end points in sweep order.
+     */
+    struct Segment
+    {
+        Point<2> left;
+        Point<2> right;
+
+        // HUGE_VAL for vertical segments
+        double slope;
+
+        void set(Point<2> const& p0, Point<2> const& p1)
+        {
+            left = sweepsBefore(p1, p0) ? p1 : p0;
+            right = sweepsBefore(p1, p0) ? p0 : p1;
+            slope = left[0] == right[0] ? HUGE_VAL : (right[1] - left[1]) / (right[0] - left[0]);
+        }
+
+        bool isDegenerate() const
+        {
+            return left[0] == right[0] && left[1] == right[1];
+        }
+
+        /**
+         * y coordinate of the segment on the sweep line passing through at.
+         * Vertical segments are cut at the sweep point itself.
+         */
+        double yAt(Point<2> const& at) const
+        {
+            if(slope == HUGE_VAL)
+            {
+                return at[1] < left[1] ? left[1] : (at[1] > right[1] ? right[1] : at[1]);
+            }
+
+            if(at[0] <= left[0])
+            {
+                return left[1];
+            }
+
+            if(at[0] >= right[0])
+            {
+                return right[1];
+            }
+
+            const double t = (at[0] - left[0]) / (right[0] - left[0]);
+            return left[1] + t * (right[1] - left[1]);
+        }
+    };
+
+    /**
+     * End point of a segment.
+     */
+    struct EndPoint
+    {
+        Point<2> pos;
+        int segment;
+        bool isStart;
+
+        bool operator<(EndPoint const& other) const
+        {
+            return sweepsBefore(pos, other.pos);
+        }
+    };
+
+    typedef std::set<Point<2>, PointLess> IntersectionQueue;
+
+    /**
+     * Orders segments from bottom to top along the sweep line, comparing
+     * exactly and breaking ties by slope and then by segment id, so it is
+     * a strict weak order. Segments marked as passing through the sweep
+     * point are taken to be exactly at it, which orders them by slope,
+     * their order just after the sweep point, whatever the rounding of
+     * their computed y.
+     */
+    class StatusLess
+    {
+    public:
+        StatusLess(std::vector<Segment> const& segments, Point<2> const& sweep,
+                   std::vector<bool> const& atSweep)
+        : segments_(&segments), sweep_(&sweep), atSweep_(&atSweep)
+        {
+        }
+
+        bool operator()(int lhs, int rhs) const
+        {
+            if(lhs == rhs)
+            {
+                return false;
+            }
+
+            Segment const& a = (*segments_)[lhs];
+            Segment const& b = (*segments_)[rhs];
+            const double ya = (*atSweep_)[lhs] ? (*sweep_)[1] : a.yAt(*sweep_);
+            const double yb = (*atSweep_)[rhs] ? (*sweep_)[1] : b.yAt(*sweep_);
+
+            if(ya != yb)
+            {
+                return ya < yb;
+            }
+
+            if(a.slope != b.slope)
+            {
+                return a.slope < b.slope;
+            }
+
+            return lhs < rhs;
+        }
+
+    private:
+        std::vector<Segment> const* segments_;
+        Point<2> const* sweep_;
+        std::vector<bool> const* atSweep_;
+    };
+
+    typedef std::set<int, StatusLess> Status;
+    typedef std::set<std::pair<int, int> > PairSet;
+
+    class Sweep
+    {
+    public:
+        Sweep(std::vector<Edge<2> > const& edges, simge::algo::IntersectionListener& listener)
+        : count_(edges.size()), segments_(edges.size() + 2),
+          status_(StatusLess(segments_, sweep_, atSweep_)), listener_(listener)
+        {
+            handles_.resize(count_);
+            inStatus_.resize(count_, false);
+            atSweep_.resize(count_ + 2, false);
+            ends_.resize(2 * count_);
+
+            for(int i = 0; i < count_; ++i)
+            {
+                segments_[i].set(edges[i][0], edges[i][1]);
+
+                ends_[2 * i].pos = segments_[i].left;
+                ends_[2 * i].segment = i;
+                ends_[2 * i].isStart = true;
+                ends_[2 * i + 1].pos = segments_[i].right;
+                ends_[2 * i + 1].segment = i;
+                ends_[2 * i + 1].isStart = false;
+            }
+
+            // End points never change so they are sorted once, only the
+            // intersections found during the sweep go to a dynamic queue.
+            std::sort(ends_.begin(), ends_.end());
+        }
+
+        void run()
+        {
+            std::vector<EndPoint>::const_iterator next = ends_.begin();
+            const std::vector<EndPoint>::const_iterator last = ends_.end();
+
+            while(next != last || !crossings_.empty())
+            {
+                Point<2> p;
+
+                if(next == last || (!crossings_.empty() && sweepsBefore(*crossings_.begin(), next->pos)))
+                {
+                    p = *crossings_.begin();
+                }
+                else
+                {
+                    p = next->pos;
+                }
+
+                if(!crossings_.empty() && !sweepsBefore(p, *crossings_.begin()))
+                {
+                    crossings_.erase(crossings_.begin());
+                }
+
+                starting_.clear();
+                ending_.clear();
+
+                while(next != last && !sweepsBefore(p, next->pos))
+                {
+                    (next->isStart ? starting_ : ending_).push_back(next->segment);
+                    ++next;
+                }
+
+                handle(p);
+            }
+        }
+
+    private:
+        /**
+         * Segments probing the status around a point. The low probe sorts
+         * before every segment passing within kEpsilon of the point, the
+         * high probe after all of them.
+         */
+        int lowProbe(Point<2> const& p)
+        {
+            segments_[count_].left = point(p[0], p[1] - kEpsilon);
+            segments_[count_].right = segments_[count_].left;
+            segments_[count_].slope = -HUGE_VAL;
+            return count_;
+        }
+
+        int highProbe(Point<2> const& p)
+        {
+            segments_[count_ + 1].left = point(p[0], p[1] + kEpsilon);
+            segments_[count_ + 1].right = segments_[count_ + 1].left;
+            segments_[count_ + 1].slope = HUGE_VAL;
+            return count_ + 1;
+        }
+
+        void handle(Point<2> const& p)
+        {
+            std::vector<int>& through = through_;
+            std::vector<int>& touching = touching_;
+
+            // The segments of the previous event were reinserted in their
+            // order after it, which their computed y keeps from now on
+            for(std::vector<int>::const_iterator it = touching.begin(); it != touching.end(); ++it)
+            {
+                atSweep_[*it] = false;
+            }
+
+            sweep_ = p;
+
+            // Segments in the status containing p, including the ones ending at p
+            through.clear();
+            Status::iterator lo = status_.lower_bound(lowProbe(p));
+            Status::iterator hi = status_.lower_bound(highProbe(p));
+
+            for(Status::iterator it = lo; it != hi; ++it)
+            {
+                through.push_back(*it);
+            }
+
+            touching = through;
+            for(std::vector<int>::const_iterator it = starting_.begin(); it != starting_.end(); ++it)
+            {
+                touching.push_back(*it);
+            }
+
+            // Ending segments not found above are still ending here
+            for(std::vector<int>::const_iterator it = ending_.begin(); it != ending_.end(); ++it)
+            {
+                if(inStatus_[*it] && !segments_[*it].isDegenerate())
+                {
+                    bool found = false;
+
+                    for(std::vector<int>::const_iterator t = through.begin(); t != through.end(); ++t)
+                    {
+                        found = found || *t == *it;
+                    }
+
+                    if(!found)
+                    {
+                        touching.push_back(*it);
+                        through.push_back(*it);
+                    }
+                }
+            }
+
+            report(p, touching);
+
+            // Erasing goes through the handles, so the marks only affect
+            // the reinsertion below
+            for(std::vector<int>::const_iterator it = through.begin(); it != through.end(); ++it)
+            {
+                erase(*it);
+            }
+
+            for(std::vector<int>::const_iterator it = touching.begin(); it != touching.end(); ++it)
+            {
+                atSweep_[*it] = true;
+            }
+
+            // Reinsert the crossing segments in their order after p
+            bool inserted = false;
+
+            for(std::vector<int>::const_iterator it = touching.begin(); it != touching.end(); ++it)
+            {
+                Segment const& s = segments_[*it];
+
+                if(!inStatus_[*it] && !s.isDegenerate() && sweepsBefore(p, s.right))
+                {
+                    insert(*it);
+                    inserted = true;
+                }
+            }
+
+            for(std::vector<int>::const_iterator it = ending_.begin(); it != ending_.end(); ++it)
+            {
+                forget(*it);
+            }
+
+            lo = status_.lower_bound(lowProbe(p));
+            hi = status_.lower_bound(highProbe(p));
+
+            if(inserted && lo != hi)
+            {
+                if(lo != status_.begin())
+                {
+                    Status::iterator below = lo;
+                    check(p, *--below, *lo);
+                }
+
+                if(hi != status_.end())
+                {
+                    Status::iterator top = hi;
+                    check(p, *--top, *hi);
+                }
+            }
+            else if(lo != status_.begin() && lo != status_.end())
+            {
+                Status::iterator below = lo;
+                check(p, *--below, *lo);
+            }
+        }
+
+        void insert(int s)
+        {
+            handles_[s] = status_.insert(s).first;
+            inStatus_[s] = true;
+        }
+
+        void erase(int s)
+        {
+            if(inStatus_[s])
+            {
+                status_.erase(handles_[s]);
+                inStatus_[s] = false;
+            }
+        }
+
+        /**
+         * Queues the intersection of two neighbouring segments if it is
+         * ahead of the sweep.
+         */
+        void check(Point<2> const& p, int a, int b)
+        {
+            Point<2> inx;
+            const Edge<2> ea(segments_[a].left, segments_[a].right);
+            const Edge<2> eb(segments_[b].left, segments_[b].right);
+
+            if(!intersection(ea, eb, inx) || !sweepsBefore(p, inx) || inx == p)
+            {
+                return;
+            }
+
+            // An event closer than kEpsilon finds both segments by itself
+            IntersectionQueue::iterator next = crossings_.lower_bound(inx);
+
+            if(next != crossings_.end() && *next == inx)
+            {
+                return;
+            }
+
+            if(next != crossings_.begin() && *--next == inx)
+            {
+                return;
+            }
+
+            crossings_.insert(inx);
+        }
+
+        /**
+         * Reports every pair of the given segments not reported before.
+         */
+        void report(Point<2> const& p, std::vector<int> const& segments)
+        {
+            const int size = segments.size();
+
+            for(int i = 0; i < size; ++i)
+            {
+                for(int j = i + 1; j < size; ++j)
+                {
+                    const int a = segments[i] < segments[j] ? segments[i] : segments[j];
+                    const int b = segments[i] < segments[j] ? segments[j] : segments[i];
+
+                    if(a != b && reported_.insert(std::make_pair(a, b)).second)
+                    {
+                        reported_.insert(std::make_pair(b, a));
+                        listener_.found(a, b, p);
+                    }
+                }
+            }
+        }
+
+        /**
+         * Drops the reported pairs of a segment that left the sweep,
+         * it cannot meet any other segment again.
+         */
+        void forget(int s)
+        {
+            PairSet::iterator it = reported_.lower_bound(std::make_pair(s, -1));
+
+            while(it != reported_.end() && it->first == s)
+            {
+                reported_.erase(std::make_pair(it->second, s));
+                reported_.erase(it++);
+            }
+        }
+
+    private:
+        int count_;
+        std::vector<Segment> segments_;
+        Point<2> sweep_;
+        std::vector<EndPoint> ends_;
+        IntersectionQueue crossings_;
+
+        // Segments passing through the current event, see StatusLess
+        std::vector<bool> atSweep_;
+        Status status_;
+        std::vector<Status::iterator> handles_;
+        std::vector<bool> inStatus_;
+
+        PairSet reported_;
+        std::vector<int> starting_;
+        std::vector<int> ending_;
+        std::vector<int> through_;
+        std::vector<int> touching_;
+        simge::algo::IntersectionListener& listener_;
+    };
+
+} // namespace <unnamed>
+
+namespace simge { namespace algo {
+
+void findAllIntersections(std::vector<Edge<2> > const& edges, IntersectionListener& listener)
+{
+    Sweep sweep(edges, listener);
+
+    sweep.run();
+}
+
+} } // namespace algo / simge
@@ -0,0 +1,282 @@
+/*
+ * Copyright (c) 2006 Emir UNER
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <vector>
+#include <queue>
+#include <cmath>
+#include <algorithm>
+
+#include <simge/algo/Simplify.hpp>
+
+using namespace simge::geom;
+
+namespace
+{
+    /**
+     * Distance of p to the segment from a to b.
+     */
+    double segmentDistance(Point<2> const& p, Point<2> const& a, Point<2> const& b)
+    {
+        const double dx = b[0] - a[0];
+        const double dy = b[1] - a[1];
+        const double lengthSquared = dx * dx + dy * dy;
+        double t = 0;
+
+        if(lengthSquared > 0)
+        {
+            t = ((p[0] - a[0]) * dx + (p[1] - a[1]) * dy) / lengthSquared;
+            t = t < 0 ? 0 : (t > 1 ? 1 : t);
+        }
+
+        const double x = a[0] + t * dx - p[0];
+        const double y = a[1] + t * dy - p[1];
+
+        return sqrt(x * x + y * y);
+    }
+
+    inline double triangleArea(Point<2> const& a, Point<2> const& b, Point<2> const& c)
+    {
+        return fabs((b[0] - a[0]) * (c[1] - a[1]) - (c[0] - a[0]) * (b[1] - a[1])) / 2;
+    }
+
+    struct Range
+    {
+        int first;
+        int last;
+        double limit;
+    };
+
+    // Area of a vertex when it was queued, stale entries are skipped
+    struct QueuedArea
+    {
+        double area;
+        int index;
+
+        bool operator<(QueuedArea const& rhs) const
+        {
+            return area > rhs.area;
+        }
+    };
+
+    /**
+     * Appends the indexes with an importance at least threshold.
+     */
+    void selectByImportance(std::vector<double> const& importance, double threshold, std::vector<int>& kept)
+    {
+        for(std::size_t i = 0; i < importance.size(); ++i)
+        {
+            if(importance[i] >= threshold)
+            {
+                kept.push_back(i);
+            }
+        }
+    }
+
+} // namespace <unnamed>
+
+namespace simge { namespace algo {
+
+void douglasPeuckerImportance(std::vector<Point<2> > const& points, std::vector<double>& importance)
+{
+    const int count = points.size();
+    std::vector<Range> ranges;
+
+    importance.assign(count, HUGE_VAL);
+
+    if(count > 2)
+    {
+        Range all = { 0, count - 1, HUGE_VAL };
+        ranges.push_back(all);
+    }
+
+    while(!ranges.empty())
+    {
+        const Range range = ranges.back();
+        int farthest = range.first + 1;
+        double distance = -1;
+
+        ranges.pop_back();
+
+        for(int i = range.first + 1; i < range.last; ++i)
+        {
+            const double d = segmentDistance(points[i], points[range.first], points[range.last]);
+
+            if(d > distance)
+            {
+                farthest = i;
+                distance = d;
+            }
+        }
+
+        // A vertex cannot outlive the vertex that split its range
+        importance[farthest] = std::min(distance, range.limit);
+
+        if(farthest - range.first > 1)
+        {
+            Range before = { range.first, farthest, importance[farthest] };
+            ranges.push_back(before);
+        }
+
+        if(range.last - farthest > 1)
+        {
+            Range after = { farthest, range.last, importance[farthest] };
+            ranges.push_back(after);
+        }
+    }
+}
+
+void visvalingamImportance(std::vector<Point<2> > const& points, std::vector<double>& importance)
+{
+    const int count = points.size();
+    std::vector<int> prev(count), next(count);
+    std::vector<double> area(count, HUGE_VAL);
+    std::priority_queue<QueuedArea> queue;
+
+    importance.assign(count, HUGE_VAL);
+
+    for(int i = 1; i + 1 < count; ++i)
+    {
+        QueuedArea queued;
+
+        prev[i] = i - 1;
+        next[i] = i + 1;
+        area[i] = triangleArea(points[i - 1], points[i], points[i + 1]);
+        queued.area = area[i];
+        queued.index = i;
+        queue.push(queued);
+    }
+
+    double largest = 0;
+
+    while(!queue.empty())
+    {
+        const QueuedArea top = queue.top();
+
+        queue.pop();
+
+        if(top.area != area[top.index] || importance[top.index] != HUGE_VAL)
+        {
+            continue;
+        }
+
+        // Removing a vertex may shrink the area of its neighbours, which
+        // must still be removed after it
+        largest = std::max(largest, top.area);
+        importance[top.index] = largest;
+
+        const int before = prev[top.index];
+        const int after = next[top.index];
+
+        next[before] = after;
+        prev[after] = before;
+
+        const int neighbours[2] = { before, after };
+
+        for(int j = 0; j < 2; ++j)
+        {
+            const int n = neighbours[j];
+
+            if(n != 0 && n != count - 1)
+            {
+                QueuedArea queued;
+
+                area[n] = triangleArea(points[prev[n]], points[n], points[next[n]]);
+                queued.area = area[n];
+                queued.index = n;
+                queue.push(queued);
+            }
+        }
+    }
+}
+
+void douglasPeucker(std::vector<Point<2> > const& points, double tolerance, std::vector<int>& kept)
+{
+    std::vector<double> importance;
+
+    douglasPeuckerImportance(points, importance);
+    selectByImportance(importance, tolerance, kept);
+}
+
+void visvalingam(std::vector<Point<2> > const& points, double minArea, std::vector<int>& kept)
+{
+    std::vector<double> importance;
+
+    visvalingamImportance(points, importance);
+    selectByImportance(importance, minArea, kept);
+}
+
+SimplificationPyramid::SimplificationPyramid()
+: root_(-1)
+{
+}
+
+SimplificationPyramid::SimplificationPyramid(std::vector<double> const& importance)
+: importance_(importance), left_(importance.size(), -1), right_(importance.size(), -1), root_(-1)
+{
+    // The right spine of the tree built so far
+    std::vector<int> spine;
+
+    for(int i = 0; i < static_cast<int>(importance_.size()); ++i)
+    {
+        int last = -1;
+
+        while(!spine.empty() && importance_[spine.back()] < importance_[i])
+        {
+            last = spine.back();
+            spine.pop_back();
+        }
+
+        left_[i] = last;
+
+        if(!spine.empty())
+        {
+            right_[spine.back()] = i;
+        }
+
+        spine.push_back(i);
+    }
+
+    root_ = spine.empty() ? -1 : spine.front();
+}
+
+void SimplificationPyramid::select(double threshold, std::vector<int>& kept) const
+{
+    std::vector<int> stack;
+    int node = root_;
+
+    // In order walk that does not descend below unimportant vertexes
+    while(!stack.empty() || (node != -1 && importance_[node] >= threshold))
+    {
+        while(node != -1 && importance_[node] >= threshold)
+        {
+            stack.push_back(node);
+            node = left_[node];
+        }
+
+        node = stack.back();
+        stack.pop_back();
+        kept.push_back(node);
+        node = right_[node];
+    }
+}
+
+} } // namespace algo / simge
@@ -0,0 +1,211 @@
+/*
+ * Copyright (c) 2006 Emir UNER
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <vector>
+#include <algorithm>
+
+#include <simge/algo/Validity.hpp>
+#include <simge/algo/SegmentIntersections.hpp>
+
+using namespace simge::geom;
+
+namespace
+{
+    /**
+     * Keeps the intersections that are not the shared vertex
+     * of two neighbouring edges.
+     */
+    class CrossingCollector : public simge::algo::IntersectionListener
+    {
+    public:
+        CrossingCollector(std::vector<Edge<2> > const& edges, std::vector<std::pair<int, int> >& crossings)
+        : edges_(edges), crossings_(crossings)
+        {
+        }
+
+        void found(int first, int second, Point<2> const&)
+        {
+            const int last = edges_.size() - 1;
+
+            if(second == first + 1 && !foldsBack(first, second))
+            {
+                return;
+            }
+
+            if(first == 0 && second == last && !foldsBack(last, first))
+            {
+                return;
+            }
+
+            crossings_.push_back(std::make_pair(first, second));
+        }
+
+    private:
+        /**
+         * Checks whether edge next, starting where edge prev ends,
+         * goes back over prev.
+         */
+        bool foldsBack(int prev, int next) const
+        {
+            const Vector<2> a = edges_[prev][1] - edges_[prev][0];
+            const Vector<2> b = edges_[next][1] - edges_[next][0];
+
+            return dot(a.ccwNormal(), b) == 0 && dot(a, b) < 0;
+        }
+
+        std::vector<Edge<2> > const& edges_;
+        std::vector<std::pair<int, int> >& crossings_;
+    };
+
+    /**
+     * Orders vertex indexes by the position of the vertexes.
+     */
+    class CompareByPosition
+    {
+    public:
+        CompareByPosition(std::vector<Point<2> > const& vertexes)
+        : vertexes_(vertexes)
+        {
+        }
+
+        bool operator()(int lhs, int rhs) const
+        {
+            Point<2> const& a = vertexes_[lhs];
+            Point<2> const& b = vertexes_[rhs];
+
+            return a[0] < b[0] || (a[0] == b[0] && (a[1] < b[1] || (a[1] == b[1] && lhs < rhs)));
+        }
+
+    private:
+        std::vector<Point<2> > const& vertexes_;
+    };
+
+    void findDuplicates(std::vector<Point<2> > const& vertexes, std::vector<int>& duplicates)
+    {
+        const int size = vertexes.size();
+        std::vector<int> order(size);
+
+        for(int i = 0; i < size; ++i)
+        {
+            order[i] = i;
+        }
+
+        std::sort(order.begin(), order.end(), CompareByPosition(vertexes));
+
+        // The first index of every run of equal vertexes is the original.
+        // Equal vertexes are next to each other in the order only when
+        // compared exactly, Point's operator== has a tolerance.
+        for(int i = 1, first = 0; i < size; ++i)
+        {
+            Point<2> const& a = vertexes[order[i]];
+            Point<2> const& b = vertexes[order[first]];
+
+            if(a[0] == b[0] && a[1] == b[1])
+            {
+                duplicates.push_back(order[i]);
+            }
+            else
+            {
+                first = i;
+            }
+        }
+
+        std::sort(duplicates.begin(), duplicates.end());
+    }
+
+    bool isWronglyOriented(Polygon<2> const& poly)
+    {
+        const Winding expected = poly.getType().value() == PolygonType::LeftIsInterior().value()
+            ? Winding::CounterClockwise()
+            : Winding::Clockwise();
+
+        return poly.getWinding() != expected;
+    }
+    
+} // namespace <unnamed>
+
+namespace simge { namespace algo {
+
+PolygonDefects validatePolygon(Polygon<2> const& poly)
+{
+    PolygonDefects defects;
+    std::vector<Point<2> > vertexes(poly.begin(), poly.end());
+    std::vector<Edge<2> > edges;
+    const int size = vertexes.size();
+
+    for(int i = 0; i < size; ++i)
+    {
+        edges.push_back(Edge<2>(vertexes[i], vertexes[(i + 1) % size]));
+    }
+
+    CrossingCollector collector(edges, defects.crossings);
+
+    findAllIntersections(edges, collector);
+    std::sort(defects.crossings.begin(), defects.crossings.end());
+
+    findDuplicates(vertexes, defects.duplicates);
+    defects.wrongOrientation = isWronglyOriented(poly);
+    defects.notMonotone = !isMonotone(poly);
+
+    return defects;
+}
+
+bool isMonotone(Polygon<2> const& poly)
+{
+    Polygon<2>::const_iterator it, end = poly.end();
+    int changes = 0;
+    int direction = 0;
+    int firstDirection = 0;
+
+    // Count the turns of the x direction around the polygon,
+    // monotone polygons turn once at each extreme.
+    for(it = poly.begin(); it != end; ++it)
+    {
+        const double dx = (*cycle(poly, it))[0] - (*it)[0];
+        const int current = dx > 0 ? 1 : (dx < 0 ? -1 : 0);
+
+        if(current == 0)
+        {
+            continue;
+        }
+
+        if(firstDirection == 0)
+        {
+            firstDirection = current;
+        }
+        else if(current != direction)
+        {
+            ++changes;
+        }
+
+        direction = current;
+    }
+
+    if(firstDirection != 0 && direction != firstDirection)
+    {
+        ++changes;
+    }
+
+    return changes <= 2;
+}
+
+} } // namespace algo / simge
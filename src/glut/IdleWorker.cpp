@@ -21,21 +21,141 @@
  */
 
 #include <simge/glut/IdleWorker.hpp>
-#include <list>
+#include <vector>
+#include <algorithm>
+#include <chrono>
 #include <GL/glut.h>
 
 namespace
 {
-    typedef std::list<simge::glut::IdleWorker*> IdleWorkerList;
-    IdleWorkerList idleWorkers;
+    using simge::glut::IdleWorker;
+
+    typedef std::chrono::steady_clock Clock;
+
+    // Weight of the latest run in the average runtime
+    const double kRuntimeWeight = 0.2;
+
+    struct IdleEntry
+    {
+        IdleWorker* worker;     // 0 once removed
+        int priority;
+        double runtime;         // Average seconds
+        bool hasRun;
+        unsigned long lastTick; // Tick of the last run or of adding
+    };
+
+    typedef std::vector<IdleEntry> IdleEntryVec;
+    IdleEntryVec idleEntries;
+
+    // Indexes of idleEntries in the order of the current tick
+    std::vector<std::size_t> idleOrder;
+
+    double idleBudget = 0;
+    unsigned long idleTick = 0;
+    bool dispatching = false;
+    bool removedAny = false;
+
+    /**
+     * The priority raised by one for every tick the worker waited.
+     */
+    inline long effectivePriority(IdleEntry const& entry)
+    {
+        return entry.priority + static_cast<long>(idleTick - entry.lastTick);
+    }
+
+    /**
+     * Higher priority first, in the order of adding for equal priorities.
+     */
+    bool hasHigherPriority(std::size_t lhs, std::size_t rhs)
+    {
+        return idleEntries[lhs].priority > idleEntries[rhs].priority;
+    }
+
+    /**
+     * Higher effective priority first, then the one that waited longest.
+     */
+    bool runsBefore(std::size_t lhs, std::size_t rhs)
+    {
+        IdleEntry const& a = idleEntries[lhs];
+        IdleEntry const& b = idleEntries[rhs];
+
+        if(effectivePriority(a) != effectivePriority(b))
+        {
+            return effectivePriority(a) > effectivePriority(b);
+        }
+
+        return a.lastTick < b.lastTick;
+    }
+
+    bool isRemoved(IdleEntry const& entry)
+    {
+        return entry.worker == 0;
+    }
 
     void idleFunc()
     {
-        IdleWorkerList::iterator it, end = idleWorkers.end();
-        
-        for(it = idleWorkers.begin(); it != end; ++it)
+        const Clock::time_point start = Clock::now();
+        const std::size_t count = idleEntries.size();
+        bool ranAny = false;
+
+        ++idleTick;
+        idleOrder.resize(count);
+
+        for(std::size_t i = 0; i < count; ++i)
+        {
+            idleOrder[i] = i;
+        }
+
+        // Without a budget every worker runs every tick and nothing needs
+        // to age. The waiting time of a worker added between ticks would
+        // otherwise differ from the others' and change the order.
+        std::stable_sort(idleOrder.begin(), idleOrder.end(),
+                         idleBudget > 0 ? &runsBefore : &hasHigherPriority);
+
+        // Entries added during dispatch are appended, so the indexes stay
+        // valid, and removed entries are only marked until it ends
+        dispatching = true;
+
+        for(std::size_t i = 0; i < count; ++i)
+        {
+            const std::size_t index = idleOrder[i];
+
+            if(isRemoved(idleEntries[index]))
+            {
+                continue;
+            }
+
+            if(idleBudget > 0 && ranAny)
+            {
+                const double elapsed = std::chrono::duration<double>(Clock::now() - start).count();
+
+                if(elapsed + idleEntries[index].runtime > idleBudget)
+                {
+                    continue;
+                }
+            }
+
+            const Clock::time_point before = Clock::now();
+
+            idleEntries[index].worker->idle();
+
+            const double runtime = std::chrono::duration<double>(Clock::now() - before).count();
+            IdleEntry& entry = idleEntries[index];
+
+            entry.runtime = entry.hasRun ? entry.runtime + kRuntimeWeight * (runtime - entry.runtime)
+                : runtime;
+            entry.hasRun = true;
+            entry.lastTick = idleTick;
+            ranAny = true;
+        }
+
+        dispatching = false;
+
+        if(removedAny)
         {
-            (*it)->idle();
+            idleEntries.erase(std::remove_if(idleEntries.begin(), idleEntries.end(), &isRemoved),
+                              idleEntries.end());
+            removedAny = false;
         }
     }
 }
@@ -43,19 +163,63 @@ namespace
 namespace simge { namespace glut {
         
 void addIdleWorker(IdleWorker* idleWorker)
+{
+    addIdleWorker(idleWorker, 0);
+}
+
+void addIdleWorker(IdleWorker* idleWorker, int priority)
 {
     // Every time we add an IdleWorker we
     // reload the glutIdleFunc. It needs to be done only once
     // but calling it more than one does no harm.
     glutIdleFunc(&idleFunc);
 
-    idleWorkers.push_back(idleWorker);
+    IdleEntry entry;
+
+    entry.worker = idleWorker;
+    entry.priority = priority;
+    entry.runtime = 0;
+    entry.hasRun = false;
+    entry.lastTick = idleTick;
+
+    idleEntries.push_back(entry);
 }
 
 void removeIdleWorker(IdleWorker* idleWorker)
 {
-    idleWorkers.remove(idleWorker);
+    for(IdleEntryVec::iterator it = idleEntries.begin(); it != idleEntries.end(); ++it)
+    {
+        if(it->worker == idleWorker)
+        {
+            it->worker = 0;
+            removedAny = true;
+        }
+    }
+
+    if(!dispatching && removedAny)
+    {
+        idleEntries.erase(std::remove_if(idleEntries.begin(), idleEntries.end(), &isRemoved),
+                          idleEntries.end());
+        removedAny = false;
+    }
 }
 
-} } // namespace glut/simge
+void setIdleBudget(double seconds)
+{
+    idleBudget = seconds;
+}
+
+double getIdleRuntime(IdleWorker* idleWorker)
+{
+    for(IdleEntryVec::const_iterator it = idleEntries.begin(); it != idleEntries.end(); ++it)
+    {
+        if(it->worker == idleWorker)
+        {
+            return it->runtime;
+        }
+    }
+
+    return 0;
+}
 
+} } // namespace glut/simge
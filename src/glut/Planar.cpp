@@ -21,22 +21,80 @@
  */
 
 #include <simge/glut/Planar.hpp>
+#include <simge/glut/Scene.hpp>
+#include <cmath>
 #include <cstdlib>
 
 namespace simge { namespace glut
 {
     
 Planar::Planar(char const* name, int mode)
-: Window(name, mode)
+: Window(name, mode), origin_(geom::point(0, 0)), scale_(1)
 {
 }
 
 void Planar::reshapeGL(int width, int height)
+{
+    applyView(width, height);
+    glViewport(0, 0, width, height);
+}
+
+void Planar::applyView(int width, int height)
 {
     glMatrixMode(GL_PROJECTION);
     glLoadIdentity();
-    glOrtho(0, width, 0, height, -1, 1);
-    glViewport(0, 0, width, height);
+    glOrtho(origin_[0], origin_[0] + width / scale_, origin_[1], origin_[1] + height / scale_, -1, 1);
+    glMatrixMode(GL_MODELVIEW);
+}
+
+void Planar::setView(geom::Point<2> const& origin, double scale)
+{
+    // The projection needs a positive finite scale
+    if(!(scale > 0 && std::isfinite(scale)))
+    {
+        return;
+    }
+
+    origin_ = origin;
+    scale_ = scale;
+
+    // May be called while another window is current, e.g. from its
+    // callbacks, so leave that window current when done
+    const int previous = glutGetWindow();
+
+    makeCurrent();
+    applyView(getWidth(), getHeight());
+
+    if(getScene() != 0)
+    {
+        getScene()->markChanged();
+    }
+
+    invalidate();
+
+    if(previous != 0)
+    {
+        glutSetWindow(previous);
+    }
+}
+
+void Planar::pan(int dx, int dy)
+{
+    setView(geom::point(origin_[0] - dx / scale_, origin_[1] + dy / scale_), scale_);
+}
+
+void Planar::zoom(double factor, int x, int y)
+{
+    const geom::Point<2> fixed = windowToGl(x, y);
+    const double scale = scale_ * factor;
+
+    setView(geom::point(fixed[0] - x / scale, fixed[1] - (getHeight() - y) / scale), scale);
+}
+
+geom::Box<2> Planar::getVisibleBox()
+{
+    return geom::box(origin_, geom::point(origin_[0] + getWidth() / scale_,
+                                          origin_[1] + getHeight() / scale_));
 }
  
 void Planar::keyboardGL(unsigned char key, int x, int y)
@@ -0,0 +1,296 @@
+/*
+ * Copyright (c) 2006 Emir UNER
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <simge/glut/Scene.hpp>
+#include <algorithm>
+#include <stdexcept>
+
+namespace simge { namespace glut
+{
+    SceneNode::SceneNode()
+    : list_(0), dirty_(true), scene_(0), order_(0), indexId_(-1), position_(-1), unboundedPosition_(-1)
+    {
+    }
+
+    SceneNode::~SceneNode()
+    {
+        if(scene_ != 0)
+        {
+            scene_->remove(this);
+        }
+
+        if(list_ != 0)
+        {
+            glDeleteLists(list_, 1);
+        }
+    }
+
+    void SceneNode::markDirty()
+    {
+        dirty_ = true;
+
+        if(scene_ != 0)
+        {
+            scene_->nodeChanged(this);
+        }
+    }
+
+    geom::Box<2> SceneNode::getBounds() const
+    {
+        return geom::Box<2>();
+    }
+
+    void SceneNode::prepare()
+    {
+    }
+
+    void SceneNode::draw()
+    {
+        if(list_ == 0)
+        {
+            list_ = glGenLists(1);
+            dirty_ = true;
+        }
+
+        if(dirty_)
+        {
+            prepare();
+            glNewList(list_, GL_COMPILE);
+            render();
+            glEndList();
+            dirty_ = false;
+        }
+
+        glCallList(list_);
+    }
+
+    Scene::Scene()
+    : removed_(0), changed_(true), nextOrder_(0)
+    {
+    }
+
+    Scene::Scene(geom::Box<2> const& world, int maxDepth)
+    : removed_(0), changed_(true), nextOrder_(0), index_(new geom::LooseQuadtree(world, maxDepth))
+    {
+    }
+
+    Scene::~Scene()
+    {
+        for(NodeVec::iterator it = nodes_.begin(); it != nodes_.end(); ++it)
+        {
+            if(*it != 0)
+            {
+                (*it)->scene_ = 0;
+            }
+        }
+    }
+
+    void Scene::add(SceneNode* node)
+    {
+        if(node->scene_ != 0)
+        {
+            throw std::runtime_error("scene node is already in a scene");
+        }
+
+        node->scene_ = this;
+        node->order_ = nextOrder_++;
+        node->position_ = nodes_.size();
+        nodes_.push_back(node);
+        index(node);
+        changed_ = true;
+    }
+
+    void Scene::remove(SceneNode* node)
+    {
+        if(node->scene_ == this)
+        {
+            unindex(node);
+            nodes_[node->position_] = 0;
+            node->position_ = -1;
+            node->scene_ = 0;
+            changed_ = true;
+
+            if(2 * ++removed_ > static_cast<int>(nodes_.size()))
+            {
+                compact();
+            }
+        }
+    }
+
+    void Scene::removeAt(NodeVec& nodes, int position, int SceneNode::* member)
+    {
+        SceneNode* const last = nodes.back();
+
+        nodes[position] = last;
+        last->*member = position;
+        nodes.pop_back();
+    }
+
+    void Scene::compact() const
+    {
+        if(removed_ == 0)
+        {
+            return;
+        }
+
+        NodeVec::iterator out = nodes_.begin();
+
+        for(NodeVec::iterator it = nodes_.begin(); it != nodes_.end(); ++it)
+        {
+            if(*it != 0)
+            {
+                (*it)->position_ = out - nodes_.begin();
+                *out++ = *it;
+            }
+        }
+
+        nodes_.erase(out, nodes_.end());
+        removed_ = 0;
+    }
+
+    void Scene::draw()
+    {
+        compact();
+
+        for(NodeVec::iterator it = nodes_.begin(); it != nodes_.end(); ++it)
+        {
+            (*it)->draw();
+        }
+
+        changed_ = false;
+    }
+
+    void Scene::draw(geom::Box<2> const& visible)
+    {
+        visible_.clear();
+        compact();
+
+        if(index_.get() == 0)
+        {
+            for(NodeVec::iterator it = nodes_.begin(); it != nodes_.end(); ++it)
+            {
+                const geom::Box<2> bounds = (*it)->getBounds();
+
+                if(bounds.isEmpty() || bounds.intersects(visible))
+                {
+                    visible_.push_back(*it);
+                }
+            }
+        }
+        else
+        {
+            found_.clear();
+            index_->query(visible, found_);
+
+            for(std::vector<int>::iterator it = found_.begin(); it != found_.end(); ++it)
+            {
+                visible_.push_back(indexed_[*it]);
+            }
+
+            visible_.insert(visible_.end(), unbounded_.begin(), unbounded_.end());
+            std::sort(visible_.begin(), visible_.end(), &Scene::isBefore);
+        }
+
+        for(NodeVec::iterator it = visible_.begin(); it != visible_.end(); ++it)
+        {
+            (*it)->draw();
+        }
+
+        changed_ = false;
+    }
+
+    void Scene::index(SceneNode* node)
+    {
+        if(index_.get() == 0)
+        {
+            return;
+        }
+
+        const geom::Box<2> bounds = node->getBounds();
+
+        if(bounds.isEmpty())
+        {
+            node->indexId_ = -1;
+            node->unboundedPosition_ = unbounded_.size();
+            unbounded_.push_back(node);
+        }
+        else
+        {
+            node->indexId_ = index_->insert(bounds);
+
+            if(node->indexId_ >= static_cast<int>(indexed_.size()))
+            {
+                indexed_.resize(node->indexId_ + 1);
+            }
+
+            indexed_[node->indexId_] = node;
+        }
+    }
+
+    void Scene::unindex(SceneNode* node)
+    {
+        if(index_.get() == 0)
+        {
+            return;
+        }
+
+        if(node->indexId_ == -1)
+        {
+            removeAt(unbounded_, node->unboundedPosition_, &SceneNode::unboundedPosition_);
+            node->unboundedPosition_ = -1;
+        }
+        else
+        {
+            index_->remove(node->indexId_);
+            indexed_[node->indexId_] = 0;
+            node->indexId_ = -1;
+        }
+    }
+
+    void Scene::nodeChanged(SceneNode* node)
+    {
+        changed_ = true;
+
+        if(index_.get() == 0)
+        {
+            return;
+        }
+
+        const geom::Box<2> bounds = node->getBounds();
+
+        if(node->indexId_ != -1 && !bounds.isEmpty())
+        {
+            index_->move(node->indexId_, bounds);
+        }
+        else if(node->indexId_ != -1 || !bounds.isEmpty())
+        {
+            unindex(node);
+            index(node);
+        }
+    }
+
+    bool Scene::isBefore(SceneNode const* lhs, SceneNode const* rhs)
+    {
+        return lhs->order_ < rhs->order_;
+    }
+
+} } // namespace glut/simge
@@ -0,0 +1,188 @@
+/*
+ * Copyright (c) 2006 Emir UNER
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <simge/glut/VertexBuffer.hpp>
+#include <GL/freeglut_ext.h> // glutGetProcAddress
+#include <cstdio>
+#include <algorithm>
+
+namespace
+{
+    // Buffer object functions are part of OpenGL 1.5, which libraries
+    // are not required to export, so they are looked up at run time.
+    PFNGLGENBUFFERSPROC genBuffers = 0;
+    PFNGLDELETEBUFFERSPROC deleteBuffers = 0;
+    PFNGLBINDBUFFERPROC bindBuffer = 0;
+    PFNGLBUFFERDATAPROC bufferData = 0;
+    PFNGLBUFFERSUBDATAPROC bufferSubData = 0;
+
+    template <typename Function>
+    bool resolve(Function& function, char const* name)
+    {
+        function = reinterpret_cast<Function>(glutGetProcAddress(name));
+
+        return function != 0;
+    }
+
+    /**
+     * Looks the buffer object functions up once, returns true if all of
+     * them were found.
+     */
+    bool resolveBufferFunctions()
+    {
+        static bool resolved = false;
+        static bool found = false;
+
+        if(!resolved)
+        {
+            resolved = true;
+            found = resolve(genBuffers, "glGenBuffers")
+                 && resolve(deleteBuffers, "glDeleteBuffers")
+                 && resolve(bindBuffer, "glBindBuffer")
+                 && resolve(bufferData, "glBufferData")
+                 && resolve(bufferSubData, "glBufferSubData");
+        }
+
+        return found;
+    }
+
+} // namespace <unnamed>
+
+namespace simge { namespace glut
+{
+    VertexBuffer::VertexBuffer()
+    : id_(0), size_(0)
+    {
+    }
+
+    VertexBuffer::~VertexBuffer()
+    {
+        if(id_ != 0)
+        {
+            deleteBuffers(1, &id_);
+        }
+    }
+
+    void VertexBuffer::create()
+    {
+        // Once the contents are in client memory they stay there
+        if(id_ == 0 && client_.empty() && isSupported())
+        {
+            genBuffers(1, &id_);
+        }
+    }
+
+    void VertexBuffer::upload(void const* data, std::size_t size)
+    {
+        create();
+
+        if(id_ != 0)
+        {
+            bindBuffer(GL_ARRAY_BUFFER, id_);
+            bufferData(GL_ARRAY_BUFFER, size, data, GL_STATIC_DRAW);
+            bindBuffer(GL_ARRAY_BUFFER, 0);
+        }
+        else
+        {
+            char const* bytes = static_cast<char const*>(data);
+
+            client_.assign(bytes, bytes + size);
+        }
+
+        size_ = size;
+    }
+
+    void VertexBuffer::allocate(std::size_t size)
+    {
+        create();
+
+        if(id_ != 0)
+        {
+            bindBuffer(GL_ARRAY_BUFFER, id_);
+            bufferData(GL_ARRAY_BUFFER, size, 0, GL_DYNAMIC_DRAW);
+            bindBuffer(GL_ARRAY_BUFFER, 0);
+        }
+        else
+        {
+            client_.resize(size);
+        }
+
+        size_ = size;
+    }
+
+    void VertexBuffer::update(std::size_t offset, void const* data, std::size_t size)
+    {
+        if(id_ != 0)
+        {
+            bindBuffer(GL_ARRAY_BUFFER, id_);
+            bufferSubData(GL_ARRAY_BUFFER, offset, size, data);
+            bindBuffer(GL_ARRAY_BUFFER, 0);
+        }
+        else if(size != 0)
+        {
+            char const* bytes = static_cast<char const*>(data);
+
+            std::copy(bytes, bytes + size, client_.begin() + offset);
+        }
+    }
+
+    void VertexBuffer::bind() const
+    {
+        if(id_ != 0)
+        {
+            bindBuffer(GL_ARRAY_BUFFER, id_);
+        }
+    }
+
+    void VertexBuffer::unbind() const
+    {
+        if(id_ != 0)
+        {
+            bindBuffer(GL_ARRAY_BUFFER, 0);
+        }
+    }
+
+    void const* VertexBuffer::getPointer(std::size_t offset) const
+    {
+        if(id_ != 0)
+        {
+            return static_cast<char const*>(0) + offset;
+        }
+
+        return client_.empty() ? 0 : client_.data() + offset;
+    }
+
+    bool VertexBuffer::isSupported()
+    {
+        char const* version = reinterpret_cast<char const*>(glGetString(GL_VERSION));
+        int major = 0;
+        int minor = 0;
+
+        if(version == 0 || sscanf(version, "%d.%d", &major, &minor) != 2)
+        {
+            return false;
+        }
+
+        return (major > 1 || (major == 1 && minor >= 5)) && resolveBufferFunctions();
+    }
+
+} } // namespace glut/simge
@@ -21,17 +21,33 @@
  */
 
 #include <simge/glut/Window.hpp>
-#include <map>
+#include <simge/glut/Scene.hpp>
+#include <vector>
+#include <stdexcept>
 
 namespace
 {
-    typedef std::map<int, simge::glut::Window*> IdWindowMap;    
-    IdWindowMap id2win;
+    // GLUT window ids are small positive numbers, so the windows are
+    // kept in a table indexed by id.
+    typedef std::vector<simge::glut::Window*> IdWindowTable;
+    IdWindowTable id2win;
+
+    typedef std::vector<void (*)(int)> DestroyListenerList;
+    DestroyListenerList destroyListeners;
+
+    /**
+     * Returns the window with the given id, 0 if there is none.
+     */
+    inline simge::glut::Window* findWindow(int id)
+    {
+        return id > 0 && id < static_cast<int>(id2win.size()) ? id2win[id] : 0;
+    }
 }
 
 namespace simge { namespace glut
 {
     Window::Window(char const* title, unsigned int mode)
+    : scene_(0), coalescing_(false), delivering_(false)
     {
         glutInitDisplayMode(mode);
         id_ = glutCreateWindow(title);
@@ -43,42 +59,127 @@ namespace simge { namespace glut
         glutPassiveMotionFunc(&Window::passiveMotionCallbackDispatcher);
         glutKeyboardFunc(&Window::keyboardCallbackDispatcher);
 
+        if(id_ >= static_cast<int>(id2win.size()))
+        {
+            id2win.resize(id_ + 1);
+        }
+
         id2win[id_] = this;
     }
     
     Window::~Window()
     {
-        id2win.erase(id2win.find(id_));
+        id2win[id_] = 0;
+
+        for(DestroyListenerList::size_type i = 0; i < destroyListeners.size(); ++i)
+        {
+            destroyListeners[i](id_);
+        }
+    }
+
+    void Window::addDestroyListener(void (*listener)(int id))
+    {
+        destroyListeners.push_back(listener);
     }
 
     void Window::displayCallbackDispatcher()
     {
-        id2win[glutGetWindow()]->paintGL();
+        Window* window = findWindow(glutGetWindow());
+
+        if(window != 0)
+        {
+            window->deliverQueued(true);
+            window->paintGL();
+        }
     }
 
     void Window::reshapeCallbackDispatcher(int width, int height)
     {
-        id2win[glutGetWindow()]->reshapeGL(width, height);
+        Window* window = findWindow(glutGetWindow());
+
+        if(window != 0)
+        {
+            window->reshapeGL(width, height);
+        }
     }
     
     void Window::mouseCallbackDispatcher(int button, int state, int x, int y)
     {
-        id2win[glutGetWindow()]->mouseGL(button, state, x, y);
+        Window* window = findWindow(glutGetWindow());
+
+        if(window != 0 && window->coalescing_)
+        {
+            InputEvent event;
+
+            event.type = InputEvent::Mouse;
+            event.button = button;
+            event.state = state;
+            event.x = x;
+            event.y = y;
+            window->queue(event);
+        }
+        else if(window != 0)
+        {
+            window->mouseGL(button, state, x, y);
+        }
     }
     
     void Window::motionCallbackDispatcher(int x, int y)
     {
-        id2win[glutGetWindow()]->motionGL(x, y);
+        Window* window = findWindow(glutGetWindow());
+
+        if(window != 0 && window->coalescing_)
+        {
+            InputEvent event;
+
+            event.type = InputEvent::Motion;
+            event.x = x;
+            event.y = y;
+            window->queue(event);
+        }
+        else if(window != 0)
+        {
+            window->motionGL(x, y);
+        }
     }
     
     void Window::passiveMotionCallbackDispatcher(int x, int y)
     {
-        id2win[glutGetWindow()]->passiveMotionGL(x, y);
+        Window* window = findWindow(glutGetWindow());
+
+        if(window != 0 && window->coalescing_)
+        {
+            InputEvent event;
+
+            event.type = InputEvent::PassiveMotion;
+            event.x = x;
+            event.y = y;
+            window->queue(event);
+        }
+        else if(window != 0)
+        {
+            window->passiveMotionGL(x, y);
+        }
     }
     
     void Window::keyboardCallbackDispatcher(unsigned char key, int x, int y)
     {
-        id2win[glutGetWindow()]->keyboardGL(key, x, y);
+        Window* window = findWindow(glutGetWindow());
+
+        if(window != 0 && window->coalescing_)
+        {
+            InputEvent event;
+
+            event.type = InputEvent::Keyboard;
+            event.key = key;
+            event.x = x;
+            event.y = y;
+            window->queue(event);
+        }
+        else if(window != 0)
+        {
+            window->keyboardGL(key, x, y);
+        }
     }
 
     int Window::getWidth() const
@@ -98,9 +199,105 @@ namespace simge { namespace glut
     
     void Window::invalidate()
     {
+        if(!delivering_)
+        {
+            glutPostRedisplay();
+        }
+    }
+
+    void Window::invalidateScene()
+    {
+        if(scene_ == 0 || scene_->isChanged())
+        {
+            invalidate();
+        }
+    }
+
+    void Window::setInputCoalescing(bool coalescing)
+    {
+        coalescing_ = coalescing;
+
+        if(!coalescing_)
+        {
+            deliverQueued(false);
+        }
+    }
+
+    bool Window::isInputCoalescing() const
+    {
+        return coalescing_;
+    }
+
+    void Window::queue(InputEvent const& event)
+    {
+        const bool isMotion = event.type == InputEvent::Motion || event.type == InputEvent::PassiveMotion;
+
+        if(isMotion && !events_.empty() && events_.back().type == event.type)
+        {
+            events_.back().x = event.x;
+            events_.back().y = event.y;
+        }
+        else
+        {
+            events_.push_back(event);
+        }
+
+        // Delivered by the display callback, repeated posts are merged
         glutPostRedisplay();
     }
 
+    void Window::deliverQueued(bool beforePaint)
+    {
+        // Handlers may queue events or switch coalescing off, which
+        // delivers again, so work on a copy
+        std::vector<InputEvent> events;
+        const bool wasDelivering = delivering_;
+
+        events.swap(events_);
+        delivering_ = wasDelivering || beforePaint;
+
+        for(std::vector<InputEvent>::const_iterator it = events.begin(); it != events.end(); ++it)
+        {
+            switch(it->type)
+            {
+            case InputEvent::Mouse:
+                mouseGL(it->button, it->state, it->x, it->y);
+                break;
+
+            case InputEvent::Motion:
+                motionGL(it->x, it->y);
+                break;
+
+            case InputEvent::PassiveMotion:
+                passiveMotionGL(it->x, it->y);
+                break;
+
+            case InputEvent::Keyboard:
+                keyboardGL(it->key, it->x, it->y);
+                break;
+            }
+        }
+
+        delivering_ = wasDelivering;
+
+        // Keep the storage for the next events
+        if(events_.empty())
+        {
+            events.clear();
+            events.swap(events_);
+        }
+    }
+
+    void Window::setScene(Scene* scene)
+    {
+        scene_ = scene;
+    }
+
+    Scene* Window::getScene() const
+    {
+        return scene_;
+    }
+
     void Window::makeCurrent()
     {
         glutSetWindow(id_);
@@ -113,7 +310,14 @@ namespace simge { namespace glut
     
     Window& Window::currentWindow()
     {
-        return *id2win[glutGetWindow()];
+        Window* window = findWindow(glutGetWindow());
+
+        if(window == 0)
+        {
+            throw std::runtime_error("current glut window is not a simge window");
+        }
+
+        return *window;
     }
 
 } } // namespace glut/simge
@@ -0,0 +1,257 @@
+/*
+ * Copyright (c) 2006 Emir UNER
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <simge/util/BinaryPolylineFile.hpp>
+
+#include <cstring>
+#include <string>
+#include <climits>
+
+namespace
+{
+    const char kMagic[8] = { 'S', 'I', 'M', 'G', 'E', 'P', 'L', '\0' };
+    const unsigned int kByteOrder = 0x01020304;
+    const unsigned int kVersion = 1;
+
+    // Size of the stdio buffer of the writer
+    const std::size_t kWriteBufferSize = 1 << 20;
+
+    inline unsigned long long alignUp(unsigned long long pos)
+    {
+        return (pos + 7) & ~7ULL;
+    }
+
+    /**
+     * True if count items of itemSize bytes starting at the aligned
+     * pos fit in size bytes. Does not overflow.
+     */
+    inline bool fits(unsigned long long pos, unsigned long long count, unsigned long long itemSize,
+                     unsigned long long size)
+    {
+        return pos % 8 == 0 && pos <= size && count <= (size - pos) / itemSize;
+    }
+    
+} // namespace <unnamed>
+
+namespace simge { namespace util {
+
+BinaryPolylineFile::BinaryPolylineFile(char const* path)
+: file_(path)
+{
+    if(file_.size() < sizeof(BinaryPolylineHeader))
+    {
+        throw std::runtime_error(std::string("not a binary polyline file: ") + path);
+    }
+
+    header_ = reinterpret_cast<BinaryPolylineHeader const*>(file_.begin());
+
+    if(memcmp(header_->magic, kMagic, sizeof(kMagic)) != 0)
+    {
+        throw std::runtime_error(std::string("not a binary polyline file: ") + path);
+    }
+
+    if(header_->byteOrder != kByteOrder)
+    {
+        throw std::runtime_error(std::string("binary polyline file has a different byte order: ") + path);
+    }
+
+    if(header_->version != kVersion
+       || (header_->dimension != 2 && header_->dimension != 3)
+       || (header_->scalarSize != sizeof(float) && header_->scalarSize != sizeof(double)))
+    {
+        throw std::runtime_error(std::string("unsupported binary polyline file: ") + path);
+    }
+
+    const unsigned long long size = file_.size();
+    const unsigned long long polylineCount = header_->polylineCount;
+    const unsigned long long pointCount = header_->pointCount;
+
+    if(polylineCount > INT_MAX
+       || !fits(header_->coordinatesPos, pointCount, header_->dimension * header_->scalarSize, size)
+       || !fits(header_->offsetsPos, polylineCount + 1, sizeof(unsigned long long), size)
+       || !fits(header_->colorsPos, polylineCount, 3 * sizeof(unsigned short), size))
+    {
+        throw std::runtime_error(std::string("binary polyline file is truncated: ") + path);
+    }
+
+    coordinates_ = file_.begin() + header_->coordinatesPos;
+    offsets_ = reinterpret_cast<unsigned long long const*>(file_.begin() + header_->offsetsPos);
+    colors_ = reinterpret_cast<unsigned short const*>(file_.begin() + header_->colorsPos);
+
+    // Polylines are read without checks, so every offset must be in order
+    // and the last one must end the coordinates
+    if(offsets_[0] != 0 || offsets_[polylineCount] != pointCount)
+    {
+        throw std::runtime_error(std::string("binary polyline file has bad offsets: ") + path);
+    }
+
+    for(unsigned long long i = 0; i < polylineCount; ++i)
+    {
+        if(offsets_[i] > offsets_[i + 1])
+        {
+            throw std::runtime_error(std::string("binary polyline file has bad offsets: ") + path);
+        }
+    }
+}
+
+double const* BinaryPolylineFile::getDoubles(int i) const
+{
+    if(hasFloatCoordinates())
+    {
+        throw std::logic_error("binary polyline file has float coordinates");
+    }
+
+    return reinterpret_cast<double const*>(coordinates_) + offsets_[i] * header_->dimension;
+}
+
+float const* BinaryPolylineFile::getFloats(int i) const
+{
+    if(!hasFloatCoordinates())
+    {
+        throw std::logic_error("binary polyline file has double coordinates");
+    }
+
+    return reinterpret_cast<float const*>(coordinates_) + offsets_[i] * header_->dimension;
+}
+
+BinaryPolylineWriter::BinaryPolylineWriter(char const* path, int dimension, bool useFloat)
+: out_(std::fopen(path, "wb")), dimension_(dimension), useFloat_(useFloat), pos_(0)
+{
+    if(out_ == 0)
+    {
+        throw std::runtime_error(std::string("cannot create ") + path);
+    }
+
+    std::setvbuf(out_, 0, _IOFBF, kWriteBufferSize);
+
+    // The header is rewritten by close() once the sizes are known
+    BinaryPolylineHeader header;
+
+    memset(&header, 0, sizeof(header));
+    put(&header, sizeof(header));
+
+    offsets_.push_back(0);
+}
+
+BinaryPolylineWriter::~BinaryPolylineWriter()
+{
+    if(out_ != 0)
+    {
+        try
+        {
+            close();
+        }
+        catch(std::exception const&)
+        {
+        }
+    }
+}
+
+void BinaryPolylineWriter::checkDimension(std::size_t pointSize) const
+{
+    if(pointSize != sizeof(double) * dimension_)
+    {
+        throw std::logic_error("binary polyline writer has a different dimension");
+    }
+}
+
+void BinaryPolylineWriter::put(void const* data, std::size_t size)
+{
+    if(size > 0 && std::fwrite(data, size, 1, out_) != 1)
+    {
+        throw std::runtime_error("binary polyline file write error");
+    }
+
+    pos_ += size;
+}
+
+void BinaryPolylineWriter::pad()
+{
+    const char zeros[8] = { 0 };
+
+    put(zeros, alignUp(pos_) - pos_);
+}
+
+void BinaryPolylineWriter::write(double const* coordinates, std::size_t pointCount, Color const& color)
+{
+    const std::size_t count = pointCount * dimension_;
+
+    if(useFloat_)
+    {
+        floats_.assign(coordinates, coordinates + count);
+        put(count == 0 ? 0 : &floats_[0], count * sizeof(float));
+    }
+    else
+    {
+        put(coordinates, count * sizeof(double));
+    }
+
+    offsets_.push_back(offsets_.back() + pointCount);
+    colors_.push_back(color.r);
+    colors_.push_back(color.g);
+    colors_.push_back(color.b);
+}
+
+void BinaryPolylineWriter::close()
+{
+    BinaryPolylineHeader header;
+
+    memcpy(header.magic, kMagic, sizeof(kMagic));
+    header.byteOrder = kByteOrder;
+    header.version = kVersion;
+    header.dimension = dimension_;
+    header.scalarSize = useFloat_ ? sizeof(float) : sizeof(double);
+    header.polylineCount = offsets_.size() - 1;
+    header.pointCount = offsets_.back();
+    header.coordinatesPos = sizeof(header);
+
+    bool failed = false;
+
+    try
+    {
+        pad();
+        header.offsetsPos = pos_;
+        put(&offsets_[0], offsets_.size() * sizeof(unsigned long long));
+
+        pad();
+        header.colorsPos = pos_;
+        put(colors_.empty() ? 0 : &colors_[0], colors_.size() * sizeof(unsigned short));
+    }
+    catch(std::runtime_error const&)
+    {
+        failed = true;
+    }
+
+    std::FILE* out = out_;
+    out_ = 0;
+
+    failed = failed
+        || std::fseek(out, 0, SEEK_SET) != 0
+        || std::fwrite(&header, sizeof(header), 1, out) != 1;
+
+    if(std::fclose(out) != 0 || failed)
+    {
+        throw std::runtime_error("binary polyline file write error");
+    }
+}
+
+} } // namespace util/simge
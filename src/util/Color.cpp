@@ -23,10 +23,9 @@
 #include <simge/util/Color.hpp>
 #include <GL/glut.h>
 
-#include <string>
 #include <istream>
-#include <cstdlib>
-#include <cstring>
+#include <ostream>
+#include <cctype>
 
 namespace
 {
@@ -47,197 +46,201 @@ namespace
     /**
      * Assumes 0 <= num <= 65535
      */
-    void writeHex4(std::ostream& out, int num)
+    char* writeHex4(char* out, int num)
     {
-        int d1 = (num & 0xf000) >> 12;
-        int d2 = (num & 0x0f00) >> 8;
-        int d3 = (num & 0x00f0) >> 4;
-        int d4 = (num & 0x000f);
-        
-        out << decToHex(d1) << decToHex(d2) << decToHex(d3) << decToHex(d4);
+        out[0] = decToHex((num & 0xf000) >> 12);
+        out[1] = decToHex((num & 0x0f00) >> 8);
+        out[2] = decToHex((num & 0x00f0) >> 4);
+        out[3] = decToHex(num & 0x000f);
+
+        return out + 4;
     }
     
     /**
      * Assumes 0 <= num <= 255
      */
-    void writeHex2(std::ostream& out, int num)
+    char* writeHex2(char* out, int num)
     {
-        int d1 = (num & 0x00f0) >> 4;
-        int d2 = (num & 0x000f);
-        
-        out << decToHex(d1) << decToHex(d2);
+        out[0] = decToHex((num & 0x00f0) >> 4);
+        out[1] = decToHex(num & 0x000f);
+
+        return out + 2;
     }
     
     /**
      * Assumes 0 <= num <= 15
      */
-    void writeHex1(std::ostream& out, int num)
+    char* writeHex1(char* out, int num)
     {
-        int d1 = (num & 0x000f);
-        
-        out << decToHex(d1);
+        out[0] = decToHex(num & 0x000f);
+
+        return out + 1;
     }
     
     /**
-     * Assumes that isxdigit(ch) == true
+     * Values of the hex digits by character, -1 for other characters.
+     * Built at compile time.
      */
-    inline int hexToDec(int ch)
+    struct HexTable
     {
-        switch(ch)
+        signed char values[256];
+
+        constexpr HexTable()
+        : values()
         {
-        case '1': return 1;
-        case '2': return 2;
-        case '3': return 3;
-        case '4': return 4;
-        case '5': return 5;
-        case '6': return 6;
-        case '7': return 7;
-        case '8': return 8;
-        case '9': return 9;
-        case '0': return 0;
-        case 'a': return 10;
-        case 'b': return 11;
-        case 'c': return 12;
-        case 'd': return 13;
-        case 'e': return 14;
-        case 'f': return 15;
-        case 'A': return 10;
-        case 'B': return 11;
-        case 'C': return 12;
-        case 'D': return 13;
-        case 'E': return 14;
-        case 'F': return 15;
+            for(int i = 0; i < 256; ++i)
+            {
+                values[i] = -1;
+            }
+
+            for(int i = 0; i < 10; ++i)
+            {
+                values['0' + i] = i;
+            }
+
+            for(int i = 0; i < 6; ++i)
+            {
+                values['a' + i] = 10 + i;
+                values['A' + i] = 10 + i;
+            }
         }
+    };
+
+    constexpr HexTable hexTable;
+
+    static_assert(hexTable.values['f'] == 15 && hexTable.values['g'] == -1, "hex table");
 
-        return -1; // Not reached.
+    inline int hexToDec(char ch)
+    {
+        return hexTable.values[static_cast<unsigned char>(ch)];
     }
     
-    /**
-     * Assumes all chars except trailing null are hex digits.
-     */
-    inline int hextToDec(char* buf)
-    {
-        int value = 0;
-        int digitValue = 1 << ((strlen(buf) - 1) * 4);
-        
-        while(*buf != '\0')
-        {
-            value += hexToDec(*buf) * digitValue;
-            ++buf;
-            digitValue >>= 4;
-        }
+} // namespace <unnamed>
+
+namespace simge { namespace util {
+
+bool parseColor(char const* str, int len, Color& color)
+{
+    const int count = len - 1;
 
-        return value;
+    if(len < 1 || str[0] != '#' || (count != 3 && count != 6 && count != 12))
+    {
+        return false;
     }
-    
-    /**
-     * Parses a color in a format #rgb, #rrggbb or #rrrrggggbbbb.
-     * Modifies buf temporarily.
-     */
-    inline simge::util::Color parseColor(char* buf, int len)
+
+    const int componentLen = count / 3;
+    const int shiftCount = (4 - componentLen) * 4;
+    int components[3];
+
+    ++str;
+    for(int i = 0; i < 3; ++i)
     {
-        simge::util::Color color;
-        const int componentLen = len / 3;
-        const int shiftCount = (4 - componentLen) * 4;
+        int value = 0;
 
-        int components[3];
-        
-        for(int i = 0; i < 3; ++i)
+        for(int j = 0; j < componentLen; ++j, ++str)
         {
-            char tmp = buf[componentLen * (i + 1)];
-            buf[componentLen * (i + 1)] = '\0';
-            components[i] = hextToDec(&buf[componentLen * i]) << shiftCount;
-            buf[componentLen * (i + 1)] = tmp;
+            const int digit = hexToDec(*str);
+
+            if(digit < 0)
+            {
+                return false;
+            }
+
+            value = (value << 4) | digit;
         }
-        
-        color.r = components[0];
-        color.g = components[1];
-        color.b = components[2];
-        
-        return color;
+
+        components[i] = value << shiftCount;
     }
-    
-} // namespace <unnamed>
 
-namespace simge { namespace util {
+    color.r = components[0];
+    color.g = components[1];
+    color.b = components[2];
+
+    return true;
+}
+
+bool parseColor(std::string_view str, Color& color)
+{
+    return parseColor(str.data(), static_cast<int>(str.size()), color);
+}
 
 std::istream& operator>>(std::istream& in, simge::util::Color& color)
 {
+    const int eof = std::istream::traits_type::eof();
+    char buf[kMaxColorChars];
+    int len = 0;
     int ch;
     
     // Skip ws.
     while(isspace(ch = in.get()));
-        
-    if(ch != '#')
-    {
-        in.setstate(std::ios::badbit);
-    }
-    else
+
+    // Consume the token but keep the white space after it
+    while(ch != eof)
     {
-        std::string buf;
-        int count;
-        
-        in >> buf;
-        count = buf.size();
-        
-        if(count != 3 && count != 6 && count != 12)
+        if(len < kMaxColorChars)
         {
-            in.setstate(std::ios::badbit);
+            buf[len] = static_cast<char>(ch);
         }
-        else
+
+        ++len;
+        ch = in.peek();
+
+        if(ch == eof || isspace(ch))
         {
-            int i;
-            
-            for(i = 0; i < count; ++i)
-            {
-                if(!isxdigit(buf[i]))
-                {
-                    in.setstate(std::ios::badbit);
-                    break;
-                }
-            }
-            
-            if(i == count)
-            {
-                char str[13];
-                strcpy(str, buf.c_str());
-                
-                color = parseColor(str, count);
-            }
+            break;
         }
+
+        in.get();
+    }
+
+    if(len > kMaxColorChars || !parseColor(buf, len, color))
+    {
+        in.setstate(std::ios::badbit);
     }
 
     return in;
 }
  
-std::ostream& operator<<(std::ostream& out, simge::util::Color const& color)
+char* formatColor(char* out, Color const& color)
 {
-    void (*writer)(std::ostream& out, int num);
+    char* (*writer)(char* out, int num);
+    int shift;
+
+    // The short forms are read as the high digits, so they can only be
+    // used when the low digits of every component are zero
+    const int bits = color.r | color.g | color.b;
 
-    if(color.r < 256 && color.g < 256 && color.b < 256)
+    if((bits & 0x0fff) == 0)
     {
-        if(color.r < 16 && color.g < 16 && color.b < 16)
-        {
-            writer = &writeHex1;
-        }
-        else
-        {
-            writer = &writeHex2;
-        }
+        writer = &writeHex1;
+        shift = 12;
+    }
+    else if((bits & 0x00ff) == 0)
+    {
+        writer = &writeHex2;
+        shift = 8;
     }
     else
     {
         writer = &writeHex4;
+        shift = 0;
     }
     
-    out << '#';
-    writer(out, color.r);
-    writer(out, color.g);
-    writer(out, color.b);
+    *out++ = '#';
+    out = writer(out, color.r >> shift);
+    out = writer(out, color.g >> shift);
+    out = writer(out, color.b >> shift);
     
     return out;
 }
 
+std::ostream& operator<<(std::ostream& out, simge::util::Color const& color)
+{
+    char buf[kMaxColorChars];
+
+    return out.write(buf, formatColor(buf, color) - buf);
+}
+
 bool operator!=(simge::util::Color const& lhs, simge::util::Color const& rhs)
 {
     return (lhs.r != rhs.r) || (lhs.g != rhs.g) || (lhs.b != rhs.b); 
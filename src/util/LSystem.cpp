@@ -0,0 +1,597 @@
+/*
+ * Copyright (c) 2006 Emir UNER
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <simge/util/LSystem.hpp>
+#include <simge/util/Conversion.hpp>
+#include <simge/geom/Operations.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <limits>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+
+namespace
+{
+    using simge::util::Turtle;
+
+    const int kSymbolCount = 256;
+
+    // The system is expanded up front for parallel interpretation until
+    // it has this many parts per thread or gets this long.
+    const std::size_t kPartsPerThread = 4;
+    const std::size_t kMaxSplitLength = 1 << 16;
+
+    // Chunks a part may have waiting before its walk blocks
+    const std::size_t kMaxQueuedChunks = 4;
+
+    struct TurtleState
+    {
+        simge::geom::Point<2> pos;
+        double angle;
+    };
+
+    struct Frame
+    {
+        char const* cur;
+        char const* end;
+        int depth;
+    };
+
+    /**
+     * Returns false if the brackets of symbols are not balanced.
+     */
+    bool isBalanced(std::string const& symbols)
+    {
+        int level = 0;
+
+        for(std::string::const_iterator it = symbols.begin(); it != symbols.end() && level >= 0; ++it)
+        {
+            level += (*it == '[') - (*it == ']');
+        }
+
+        return level == 0;
+    }
+
+    inline bool isLine(char ch)
+    {
+        return ch == 'F' || ch == 'G';
+    }
+
+    inline unsigned long long saturatingAdd(unsigned long long a, unsigned long long b)
+    {
+        return a > std::numeric_limits<unsigned long long>::max() - b
+            ? std::numeric_limits<unsigned long long>::max() : a + b;
+    }
+
+    void flushTurtle(Turtle& turtle, void*)
+    {
+        turtle.flush();
+    }
+
+    /**
+     * Thrown by a parallel walk whose results are no longer wanted.
+     */
+    struct WalkStopped
+    {
+    };
+
+} // namespace <unnamed>
+
+namespace simge { namespace util {
+
+using namespace geom;
+
+LSystem::LSystem(char const* axiom, double step, double angle)
+: axiom_(axiom), step_(step), angle_(angle), rules_(kSymbolCount), hasRule_(kSymbolCount, false)
+{
+    if(!isBalanced(axiom_))
+    {
+        throw std::runtime_error("l-system axiom has unbalanced brackets");
+    }
+}
+
+void LSystem::addRule(char symbol, char const* replacement)
+{
+    const unsigned char index = symbol;
+
+    rules_[index] = replacement;
+
+    if(!isBalanced(rules_[index]))
+    {
+        rules_[index].clear();
+        hasRule_[index] = false;
+        throw std::runtime_error("l-system rule has unbalanced brackets");
+    }
+
+    hasRule_[index] = true;
+}
+
+/**
+ * State shared by the threads of interpretParallel. The threads take the
+ * parts in order and queue their lines in chunks, which the calling thread
+ * takes in order. Destroying it stops and joins the threads.
+ */
+struct LSystem::ParallelWalk
+{
+    /**
+     * A contiguous range of symbols walked by one thread.
+     */
+    struct Part
+    {
+        std::size_t begin;
+        std::size_t end;
+        std::deque<Turtle> chunks;
+        bool finished;
+
+        // Where the part's turtle left off, relative to its start
+        Point<2> pos;
+        double angle;
+    };
+
+    struct ChunkTarget
+    {
+        ParallelWalk* walk;
+        std::size_t part;
+    };
+
+    ParallelWalk(LSystem const& system, std::string const& symbols, int depth,
+                 std::size_t chunkSize, Color const& color)
+    : system(system), symbols(symbols), depth(depth), chunkSize(chunkSize), color(color),
+      nextPart(0), stopped(false)
+    {
+    }
+
+    ~ParallelWalk()
+    {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+
+            stopped = true;
+        }
+
+        changed.notify_all();
+
+        for(std::size_t i = 0; i < threads.size(); ++i)
+        {
+            threads[i].join();
+        }
+    }
+
+    void work()
+    {
+        try
+        {
+            for(;;)
+            {
+                std::size_t index;
+
+                {
+                    std::lock_guard<std::mutex> lock(mutex);
+
+                    if(stopped || nextPart == parts.size())
+                    {
+                        return;
+                    }
+
+                    index = nextPart++;
+                }
+
+                walkPart(index);
+            }
+        }
+        catch(WalkStopped const&)
+        {
+        }
+        catch(...)
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+
+            if(!error)
+            {
+                error = std::current_exception();
+            }
+
+            stopped = true;
+            changed.notify_all();
+        }
+    }
+
+    void walkPart(std::size_t index)
+    {
+        Turtle turtle(point(0, 0), color);
+        ChunkTarget target = { this, index };
+
+        turtle.setRecording(true);
+        system.walk(symbols.data() + parts[index].begin, symbols.data() + parts[index].end, depth,
+                    turtle, chunkSize, &ParallelWalk::queueChunk, &target);
+
+        Turtle chunk;
+
+        chunk.appendRecording(turtle);
+
+        std::lock_guard<std::mutex> lock(mutex);
+        Part& part = parts[index];
+
+        if(chunk.getSegmentCount() != 0)
+        {
+            part.chunks.push_back(std::move(chunk));
+        }
+
+        part.pos = turtle.getPosition();
+        part.angle = turtle.getAngle();
+        part.finished = true;
+        changed.notify_all();
+    }
+
+    static void queueChunk(Turtle& turtle, void* context)
+    {
+        ChunkTarget const& target = *static_cast<ChunkTarget*>(context);
+        ParallelWalk& walk = *target.walk;
+        Turtle chunk;
+
+        chunk.appendRecording(turtle);
+        turtle.clearRecording();
+
+        std::unique_lock<std::mutex> lock(walk.mutex);
+        Part& part = walk.parts[target.part];
+
+        while(!walk.stopped && part.chunks.size() >= kMaxQueuedChunks)
+        {
+            walk.changed.wait(lock);
+        }
+
+        if(walk.stopped)
+        {
+            throw WalkStopped();
+        }
+
+        part.chunks.push_back(std::move(chunk));
+        walk.changed.notify_all();
+    }
+
+    /**
+     * Moves the next chunk of the part into chunk, waiting for it.
+     * Returns false if the part has no more chunks. Rethrows the error
+     * of a failed thread.
+     */
+    bool takeChunk(std::size_t index, Turtle& chunk)
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        Part& part = parts[index];
+
+        while(!error && part.chunks.empty() && !part.finished)
+        {
+            changed.wait(lock);
+        }
+
+        if(error)
+        {
+            std::rethrow_exception(error);
+        }
+
+        if(part.chunks.empty())
+        {
+            return false;
+        }
+
+        chunk = std::move(part.chunks.front());
+        part.chunks.pop_front();
+        changed.notify_all();
+
+        return true;
+    }
+
+    LSystem const& system;
+    std::string const& symbols;
+    const int depth;
+    const std::size_t chunkSize;
+    const Color color;
+
+    std::vector<Part> parts;
+    std::size_t nextPart;
+    bool stopped;
+    std::exception_ptr error;
+
+    std::mutex mutex;
+    std::condition_variable changed;
+    std::vector<std::thread> threads;
+};
+
+void LSystem::countSymbolSegments(int depth, std::vector<unsigned long long>& counts) const
+{
+    std::vector<unsigned long long> next(kSymbolCount);
+
+    counts.resize(kSymbolCount);
+
+    for(int ch = 0; ch < kSymbolCount; ++ch)
+    {
+        counts[ch] = isLine(ch) ? 1 : 0;
+    }
+
+    for(int i = 0; i < depth; ++i)
+    {
+        for(int ch = 0; ch < kSymbolCount; ++ch)
+        {
+            if(hasRule_[ch])
+            {
+                unsigned long long sum = 0;
+
+                for(std::string::const_iterator it = rules_[ch].begin(); it != rules_[ch].end(); ++it)
+                {
+                    sum = saturatingAdd(sum, counts[static_cast<unsigned char>(*it)]);
+                }
+
+                next[ch] = sum;
+            }
+            else
+            {
+                next[ch] = counts[ch];
+            }
+        }
+
+        counts.swap(next);
+    }
+}
+
+unsigned long long LSystem::countSegments(int depth) const
+{
+    std::vector<unsigned long long> counts;
+    unsigned long long total = 0;
+
+    countSymbolSegments(depth, counts);
+
+    for(std::string::const_iterator it = axiom_.begin(); it != axiom_.end(); ++it)
+    {
+        total = saturatingAdd(total, counts[static_cast<unsigned char>(*it)]);
+    }
+
+    return total;
+}
+
+void LSystem::interpret(Turtle& turtle, int depth, std::size_t flushEvery) const
+{
+    walk(axiom_.data(), axiom_.data() + axiom_.size(), depth, turtle, flushEvery, &flushTurtle, 0);
+}
+
+void LSystem::walk(char const* begin, char const* end, int depth, Turtle& turtle,
+                   std::size_t flushEvery, FlushFunction flush, void* context) const
+{
+    std::vector<Frame> frames;
+    std::vector<TurtleState> saved;
+    Frame first = { begin, end, depth };
+
+    frames.push_back(first);
+
+    while(!frames.empty())
+    {
+        Frame& frame = frames.back();
+
+        if(frame.cur == frame.end)
+        {
+            frames.pop_back();
+            continue;
+        }
+
+        const unsigned char ch = *frame.cur++;
+
+        if(frame.depth > 0 && hasRule_[ch])
+        {
+            std::string const& rule = rules_[ch];
+            Frame expansion = { rule.data(), rule.data() + rule.size(), frame.depth - 1 };
+
+            frames.push_back(expansion);
+            continue;
+        }
+
+        switch(ch)
+        {
+        case 'F':
+        case 'G':
+            turtle.forward(step_);
+
+            if(turtle.isRecording() && turtle.getSegmentCount() >= flushEvery)
+            {
+                flush(turtle, context);
+            }
+            break;
+
+        case 'f':
+            turtle.forward(step_, false);
+            break;
+
+        case '+':
+            turtle.turn(angle_);
+            break;
+
+        case '-':
+            turtle.turn(-angle_);
+            break;
+
+        case '[':
+            {
+                TurtleState state;
+
+                state.pos = turtle.getPosition();
+                state.angle = turtle.getAngle();
+                saved.push_back(state);
+            }
+            break;
+
+        case ']':
+            turtle.moveTo(saved.back().pos);
+            turtle.turnTo(saved.back().angle);
+            saved.pop_back();
+            break;
+        }
+    }
+}
+
+std::string LSystem::expand(std::string const& symbols) const
+{
+    std::string result;
+
+    for(std::string::const_iterator it = symbols.begin(); it != symbols.end(); ++it)
+    {
+        const unsigned char ch = *it;
+
+        if(hasRule_[ch])
+        {
+            result += rules_[ch];
+        }
+        else
+        {
+            result += ch;
+        }
+    }
+
+    return result;
+}
+
+void LSystem::interpretParallel(Turtle& turtle, int depth, int threadCount, std::size_t flushEvery) const
+{
+    if(threadCount <= 0)
+    {
+        threadCount = std::thread::hardware_concurrency();
+        threadCount = threadCount <= 0 ? 1 : threadCount;
+    }
+
+    // Expand a few iterations so that there are enough parts at bracket
+    // level 0, each of which can be walked on its own
+    std::string symbols = axiom_;
+    std::vector<std::size_t> units;
+
+    for(;;)
+    {
+        int level = 0;
+
+        units.clear();
+
+        for(std::size_t i = 0; i < symbols.size(); ++i)
+        {
+            if(level == 0)
+            {
+                units.push_back(i);
+            }
+
+            level += (symbols[i] == '[') - (symbols[i] == ']');
+        }
+
+        if(depth == 0 || units.size() >= kPartsPerThread * threadCount || symbols.size() >= kMaxSplitLength)
+        {
+            break;
+        }
+
+        symbols = expand(symbols);
+        --depth;
+    }
+
+    units.push_back(symbols.size());
+
+    // Weigh the units by the lines they draw and cut them into parts of
+    // about the same weight, a few per thread to balance the load
+    std::vector<unsigned long long> counts;
+    std::vector<unsigned long long> weights(units.size() - 1);
+    unsigned long long total = 0;
+
+    countSymbolSegments(depth, counts);
+
+    for(std::size_t i = 0; i + 1 < units.size(); ++i)
+    {
+        unsigned long long weight = 1;
+
+        for(std::size_t j = units[i]; j < units[i + 1]; ++j)
+        {
+            weight = saturatingAdd(weight, counts[static_cast<unsigned char>(symbols[j])]);
+        }
+
+        weights[i] = weight;
+        total = saturatingAdd(total, weight);
+    }
+
+    ParallelWalk walk(*this, symbols, depth, flushEvery, turtle.getTailColor());
+    const unsigned long long target = total / (kPartsPerThread * threadCount) + 1;
+    unsigned long long weight = 0;
+
+    for(std::size_t i = 0; i + 1 < units.size(); ++i)
+    {
+        if(walk.parts.empty() || weight >= target)
+        {
+            ParallelWalk::Part part;
+
+            part.begin = units[i];
+            part.finished = false;
+            walk.parts.push_back(part);
+            weight = 0;
+        }
+
+        walk.parts.back().end = units[i + 1];
+        weight += weights[i];
+    }
+
+    // Reserved so that adding a started thread cannot throw, the walk
+    // joins the threads started so far if starting one fails
+    threadCount = std::min<std::size_t>(threadCount, walk.parts.size());
+    walk.threads.reserve(threadCount);
+
+    for(int i = 0; i < threadCount; ++i)
+    {
+        walk.threads.push_back(std::thread(&ParallelWalk::work, &walk));
+    }
+
+    // Every part continues where the one before it left off
+    Point<2> pos = turtle.getPosition();
+    double angle = turtle.getAngle();
+    Turtle chunk;
+
+    for(std::size_t i = 0; i < walk.parts.size(); ++i)
+    {
+        while(walk.takeChunk(i, chunk))
+        {
+            chunk.transformRecording(pos - point(0, 0), angle);
+            turtle.appendRecording(chunk);
+
+            if(turtle.isRecording() && turtle.getSegmentCount() >= flushEvery)
+            {
+                turtle.flush();
+            }
+        }
+
+        // The part is finished, so its end is no longer written
+        ParallelWalk::Part const& part = walk.parts[i];
+        const Vector<2> moved = part.pos - point(0, 0);
+        const double c = cos(degreeToRadian(angle));
+        const double s = sin(degreeToRadian(angle));
+
+        pos = point(pos[0] + c * moved[0] - s * moved[1], pos[1] + s * moved[0] + c * moved[1]);
+        angle = fmod(angle + part.angle, 360.0);
+    }
+
+    turtle.moveTo(pos);
+    turtle.turnTo(angle);
+}
+
+} } // namespace util/simge
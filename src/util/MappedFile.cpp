@@ -0,0 +1,81 @@
+/*
+ * Copyright (c) 2006 Emir UNER
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <simge/util/MappedFile.hpp>
+
+#include <string>
+#include <stdexcept>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+namespace simge { namespace util {
+
+MappedFile::MappedFile(char const* path)
+: data_(0), size_(0), modificationTime_(0)
+{
+    const int fd = open(path, O_RDONLY);
+    struct stat st;
+
+    if(fd == -1)
+    {
+        throw std::runtime_error(std::string("cannot open ") + path);
+    }
+
+    if(fstat(fd, &st) == -1)
+    {
+        close(fd);
+        throw std::runtime_error(std::string("cannot stat ") + path);
+    }
+
+    size_ = st.st_size;
+    modificationTime_ = static_cast<unsigned long long>(st.st_mtim.tv_sec) * 1000000000ULL + st.st_mtim.tv_nsec;
+
+    // Zero length mappings are not allowed, an empty file has no data.
+    if(size_ > 0)
+    {
+        void* data = mmap(0, size_, PROT_READ, MAP_PRIVATE, fd, 0);
+
+        if(data == MAP_FAILED)
+        {
+            close(fd);
+            throw std::runtime_error(std::string("cannot map ") + path);
+        }
+
+        // Files are scanned front to back
+        madvise(data, size_, MADV_SEQUENTIAL);
+        data_ = static_cast<char const*>(data);
+    }
+
+    close(fd);
+}
+
+MappedFile::~MappedFile()
+{
+    if(data_ != 0)
+    {
+        munmap(const_cast<char*>(data_), size_);
+    }
+}
+
+} } // namespace util/simge
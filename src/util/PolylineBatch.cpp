@@ -0,0 +1,203 @@
+/*
+ * Copyright (c) 2006 Emir UNER
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+// glMultiDrawArrays is part of OpenGL 1.4 but the headers only declare it
+// when asked to.
+#define GL_GLEXT_PROTOTYPES
+
+#include <simge/util/PolylineBatch.hpp>
+#include <stdexcept>
+
+namespace simge { namespace util {
+
+PolylineBatch::PolylineBatch()
+: hasOrigin_(false), size_(0), removed_(0), uploaded_(0), reupload_(false)
+{
+}
+
+int PolylineBatch::append(double const* coordinates, std::size_t pointCount, int dimension, Color const& color)
+{
+    if(dimension != 2 && dimension != 3)
+    {
+        throw std::runtime_error("polyline batch dimension must be 2 or 3");
+    }
+
+    if(!hasOrigin_ && pointCount != 0)
+    {
+        for(int i = 0; i < 3; ++i)
+        {
+            origin_[i] = i < dimension ? coordinates[i] : 0;
+        }
+
+        hasOrigin_ = true;
+    }
+
+    int id;
+
+    if(freeIds_.empty())
+    {
+        id = firsts_.size();
+        firsts_.push_back(0);
+        counts_.push_back(0);
+        used_.push_back(false);
+    }
+    else
+    {
+        id = freeIds_.back();
+        freeIds_.pop_back();
+    }
+
+    Vertex vertex;
+
+    vertex.color[0] = color.r >> 8;
+    vertex.color[1] = color.g >> 8;
+    vertex.color[2] = color.b >> 8;
+    vertex.color[3] = 255;
+    vertex.position[2] = 0;
+
+    firsts_[id] = vertexes_.size();
+    counts_[id] = pointCount;
+    used_[id] = true;
+
+    for(std::size_t i = 0; i < pointCount; ++i, coordinates += dimension)
+    {
+        for(int j = 0; j < dimension; ++j)
+        {
+            vertex.position[j] = static_cast<float>(coordinates[j] - origin_[j]);
+        }
+
+        vertexes_.push_back(vertex);
+    }
+
+    ++size_;
+
+    return id;
+}
+
+void PolylineBatch::remove(int id)
+{
+    if(id < 0 || id >= static_cast<int>(counts_.size()) || !used_[id])
+    {
+        throw std::runtime_error("no polyline with the given id in batch");
+    }
+
+    removed_ += counts_[id];
+    counts_[id] = 0;
+    used_[id] = false;
+    freeIds_.push_back(id);
+    --size_;
+
+    if(removed_ * 2 > vertexes_.size())
+    {
+        compact();
+    }
+}
+
+void PolylineBatch::clear()
+{
+    vertexes_.clear();
+    firsts_.clear();
+    counts_.clear();
+    used_.clear();
+    freeIds_.clear();
+    hasOrigin_ = false;
+    size_ = 0;
+    removed_ = 0;
+    uploaded_ = 0;
+    reupload_ = true;
+}
+
+void PolylineBatch::compact()
+{
+    // Ids are reused, so their vertexes are not in id order
+    std::vector<Vertex> packed;
+
+    packed.reserve(vertexes_.size() - removed_);
+
+    for(std::size_t id = 0; id < counts_.size(); ++id)
+    {
+        if(used_[id])
+        {
+            const int first = packed.size();
+
+            packed.insert(packed.end(), vertexes_.begin() + firsts_[id],
+                          vertexes_.begin() + firsts_[id] + counts_[id]);
+            firsts_[id] = first;
+        }
+    }
+
+    vertexes_.swap(packed);
+    removed_ = 0;
+    reupload_ = true;
+}
+
+void PolylineBatch::upload()
+{
+    const std::size_t needed = vertexes_.size() * sizeof(Vertex);
+
+    if(needed > buffer_.size())
+    {
+        // Grow geometrically so that appends are uploaded in place
+        buffer_.allocate(needed > 2 * buffer_.size() ? needed : 2 * buffer_.size());
+        reupload_ = true;
+    }
+
+    if(reupload_)
+    {
+        uploaded_ = 0;
+        reupload_ = false;
+    }
+
+    if(uploaded_ < vertexes_.size())
+    {
+        buffer_.update(uploaded_ * sizeof(Vertex), &vertexes_[uploaded_],
+                       (vertexes_.size() - uploaded_) * sizeof(Vertex));
+        uploaded_ = vertexes_.size();
+    }
+}
+
+void PolylineBatch::draw()
+{
+    if(vertexes_.empty())
+    {
+        return;
+    }
+
+    upload();
+
+    glPushMatrix();
+    glTranslated(origin_[0], origin_[1], origin_[2]);
+
+    glPushClientAttrib(GL_CLIENT_VERTEX_ARRAY_BIT);
+    glEnableClientState(GL_VERTEX_ARRAY);
+    glEnableClientState(GL_COLOR_ARRAY);
+    buffer_.bind();
+    glVertexPointer(3, GL_FLOAT, sizeof(Vertex), buffer_.getPointer(offsetof(Vertex, position)));
+    glColorPointer(4, GL_UNSIGNED_BYTE, sizeof(Vertex), buffer_.getPointer(offsetof(Vertex, color)));
+    glMultiDrawArrays(GL_LINE_STRIP, &firsts_[0], &counts_[0], counts_.size());
+    buffer_.unbind();
+    glPopClientAttrib();
+
+    glPopMatrix();
+}
+
+} } // namespace util/simge
@@ -0,0 +1,293 @@
+/*
+ * Copyright (c) 2006 Emir UNER
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <simge/util/PolylineCodec.hpp>
+
+#include <algorithm>
+#include <climits>
+#include <cmath>
+#include <cstring>
+#include <istream>
+#include <ostream>
+
+namespace
+{
+    const char kMagic[8] = { 'S', 'I', 'M', 'G', 'E', 'D', 'Z', '\0' };
+    const unsigned long long kVersion = 1;
+
+    // Quantized coordinates must leave room for their differences
+    const double kMaxQuantized = 4611686018427387904.0; // 2^62
+
+    const int kMaxDimension = 3;
+
+    const int kMaxVarintBytes = 10;
+
+    const unsigned long long kMaxRecordBytes = 1ULL << 30;
+
+    // Record data is read in steps of this size, so that a size read
+    // from a truncated or corrupt file does not allocate all of it
+    const std::size_t kRecordReadStep = 1 << 20;
+
+    inline long long quantize(double value, double resolution)
+    {
+        const double q = std::floor(value / resolution + 0.5);
+
+        if(!(std::fabs(q) < kMaxQuantized))
+        {
+            throw std::runtime_error("coordinate too large for the polyline resolution");
+        }
+
+        return static_cast<long long>(q);
+    }
+
+    void writeVarint(std::ostream& out, unsigned long long value)
+    {
+        unsigned char buf[kMaxVarintBytes];
+
+        out.write(reinterpret_cast<char const*>(buf), simge::util::putVarint(buf, value) - buf);
+    }
+
+    unsigned long long readVarint(std::istream& in)
+    {
+        unsigned long long result = 0;
+
+        for(int shift = 0; shift < 64; shift += 7)
+        {
+            const int ch = in.get();
+
+            if(ch == std::istream::traits_type::eof())
+            {
+                break;
+            }
+
+            result |= static_cast<unsigned long long>(ch & 0x7f) << shift;
+
+            if(ch < 0x80)
+            {
+                return result;
+            }
+        }
+
+        throw std::runtime_error("compressed polyline file format not correct");
+    }
+
+} // namespace <unnamed>
+
+namespace simge { namespace util {
+
+void encodePoints(double const* coordinates, std::size_t pointCount, int dimension,
+                  double resolution, std::vector<unsigned char>& out)
+{
+    long long previous[kMaxDimension] = { 0, 0, 0 };
+    std::size_t size = out.size();
+
+    out.resize(size + pointCount * dimension * kMaxVarintBytes);
+
+    unsigned char* const begin = &out[0] + size;
+    unsigned char* cur = begin;
+
+    for(std::size_t i = 0; i < pointCount; ++i)
+    {
+        for(int d = 0; d < dimension; ++d, ++coordinates)
+        {
+            const long long q = quantize(*coordinates, resolution);
+
+            cur = putVarint(cur, zigzag(q - previous[d]));
+            previous[d] = q;
+        }
+    }
+
+    out.resize(size + (cur - begin));
+}
+
+unsigned char const* decodePoints(unsigned char const* cur, unsigned char const* end, std::size_t pointCount,
+                                  int dimension, double resolution, double* out)
+{
+    long long previous[kMaxDimension] = { 0, 0, 0 };
+    double* const last = out + pointCount * dimension;
+
+    while(out != last)
+    {
+        for(int d = 0; d < dimension; ++d, ++out)
+        {
+            unsigned long long delta;
+
+            // Most differences of smooth paths fit in one byte
+            if(cur != end && *cur < 0x80)
+            {
+                delta = *cur++;
+            }
+            else if(end - cur >= kMaxVarintBytes)
+            {
+                // The varint ends before end, no need to check every byte
+                delta = *cur & 0x7f;
+
+                for(int shift = 7; *cur++ >= 0x80; shift += 7)
+                {
+                    if(shift >= 64)
+                    {
+                        throw std::runtime_error("compressed polyline data not correct");
+                    }
+
+                    delta |= static_cast<unsigned long long>(*cur & 0x7f) << shift;
+                }
+            }
+            else if(!getVarint(cur, end, delta))
+            {
+                throw std::runtime_error("compressed polyline data not correct");
+            }
+
+            previous[d] += unzigzag(delta);
+            *out = previous[d] * resolution;
+        }
+    }
+
+    return cur;
+}
+
+void writeCompressedHeader(std::ostream& out, CompressedPolylineHeader const& header)
+{
+    unsigned long long bits;
+    unsigned char bytes[8];
+
+    memcpy(&bits, &header.resolution, sizeof(bits));
+
+    for(int i = 0; i < 8; ++i)
+    {
+        bytes[i] = static_cast<unsigned char>(bits >> (8 * i));
+    }
+
+    out.write(kMagic, sizeof(kMagic));
+    writeVarint(out, kVersion);
+    writeVarint(out, header.dimension);
+    writeVarint(out, header.polylineCount);
+    out.write(reinterpret_cast<char const*>(bytes), sizeof(bytes));
+
+    if(!out)
+    {
+        throw std::runtime_error("compressed polyline file error while writing");
+    }
+}
+
+CompressedPolylineHeader readCompressedHeader(std::istream& in)
+{
+    char magic[sizeof(kMagic)];
+    CompressedPolylineHeader header;
+
+    if(!in.read(magic, sizeof(magic)) || memcmp(magic, kMagic, sizeof(kMagic)) != 0)
+    {
+        throw std::runtime_error("not a compressed polyline file");
+    }
+
+    if(readVarint(in) != kVersion)
+    {
+        throw std::runtime_error("unsupported compressed polyline file");
+    }
+
+    const unsigned long long dimension = readVarint(in);
+    const unsigned long long polylineCount = readVarint(in);
+
+    if(dimension > kMaxDimension || polylineCount > INT_MAX)
+    {
+        throw std::runtime_error("unsupported compressed polyline file");
+    }
+
+    header.dimension = static_cast<int>(dimension);
+    header.polylineCount = static_cast<int>(polylineCount);
+
+    unsigned char bytes[8];
+    unsigned long long bits = 0;
+
+    if(!in.read(reinterpret_cast<char*>(bytes), sizeof(bytes)))
+    {
+        throw std::runtime_error("compressed polyline file format not correct");
+    }
+
+    for(int i = 0; i < 8; ++i)
+    {
+        bits |= static_cast<unsigned long long>(bytes[i]) << (8 * i);
+    }
+
+    memcpy(&header.resolution, &bits, sizeof(bits));
+
+    if((header.dimension != 2 && header.dimension != 3) || !(header.resolution > 0))
+    {
+        throw std::runtime_error("unsupported compressed polyline file");
+    }
+
+    return header;
+}
+
+void writeCompressedRecord(std::ostream& out, std::size_t pointCount, Color const& color,
+                           std::vector<unsigned char> const& data)
+{
+    writeVarint(out, pointCount);
+    writeVarint(out, color.r);
+    writeVarint(out, color.g);
+    writeVarint(out, color.b);
+    writeVarint(out, data.size());
+
+    if(!data.empty())
+    {
+        out.write(reinterpret_cast<char const*>(&data[0]), data.size());
+    }
+
+    if(!out)
+    {
+        throw std::runtime_error("compressed polyline file error while writing");
+    }
+}
+
+void readCompressedRecord(std::istream& in, int dimension, std::size_t& pointCount, Color& color,
+                          std::vector<unsigned char>& data)
+{
+    const unsigned long long count = readVarint(in);
+
+    color.r = readVarint(in) & 0xffff;
+    color.g = readVarint(in) & 0xffff;
+    color.b = readVarint(in) & 0xffff;
+
+    const unsigned long long size = readVarint(in);
+
+    // Every coordinate takes at least one byte
+    if(size > kMaxRecordBytes || count > size / dimension)
+    {
+        throw std::runtime_error("compressed polyline file format not correct");
+    }
+
+    pointCount = count;
+    data.clear();
+
+    while(data.size() != size)
+    {
+        const std::size_t first = data.size();
+
+        data.resize(first + std::min<std::size_t>(size - first, kRecordReadStep));
+
+        if(!in.read(reinterpret_cast<char*>(data.data() + first), data.size() - first))
+        {
+            throw std::runtime_error("compressed polyline file format not correct");
+        }
+    }
+}
+
+} } // namespace util/simge
@@ -0,0 +1,200 @@
+/*
+ * Copyright (c) 2006 Emir UNER
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <simge/util/PolylineIndex.hpp>
+
+#include <cstring>
+#include <string>
+#include <stdexcept>
+
+namespace
+{
+    const char kMagic[8] = { 'S', 'I', 'M', 'G', 'E', 'I', 'X', '\0' };
+    const unsigned int kByteOrder = 0x01020304;
+    const unsigned int kVersion = 2;
+
+    // Size of the stdio buffer of the writer
+    const std::size_t kWriteBufferSize = 1 << 20;
+
+    // Deepest level of the query tree, 4^8 leaves at most
+    const int kMaxTreeDepth = 8;
+    
+} // namespace <unnamed>
+
+namespace simge { namespace util {
+
+PolylineIndex::PolylineIndex(char const* path)
+: file_(path)
+{
+    if(file_.size() < sizeof(PolylineIndexHeader))
+    {
+        throw std::runtime_error(std::string("not a polyline index: ") + path);
+    }
+
+    header_ = reinterpret_cast<PolylineIndexHeader const*>(file_.begin());
+
+    if(memcmp(header_->magic, kMagic, sizeof(kMagic)) != 0)
+    {
+        throw std::runtime_error(std::string("not a polyline index: ") + path);
+    }
+
+    if(header_->byteOrder != kByteOrder)
+    {
+        throw std::runtime_error(std::string("polyline index has a different byte order: ") + path);
+    }
+
+    if(header_->version != kVersion)
+    {
+        throw std::runtime_error(std::string("unsupported polyline index: ") + path);
+    }
+
+    if(header_->polylineCount > (file_.size() - sizeof(PolylineIndexHeader)) / sizeof(PolylineIndexEntry))
+    {
+        throw std::runtime_error(std::string("polyline index is truncated: ") + path);
+    }
+
+    entries_ = reinterpret_cast<PolylineIndexEntry const*>(file_.begin() + sizeof(PolylineIndexHeader));
+    buildTree();
+}
+
+void PolylineIndex::buildTree()
+{
+    const int count = getPolylineCount();
+    geom::Box<2> world;
+    int depth = 0;
+
+    for(int i = 0; i < count; ++i)
+    {
+        world.extend(getBounds(i));
+    }
+
+    if(world.isEmpty())
+    {
+        return;
+    }
+
+    // About one polyline per leaf
+    while(depth < kMaxTreeDepth && (1 << (2 * depth)) < count)
+    {
+        ++depth;
+    }
+
+    // A zero sized world would make every cell empty, use a unit box around it
+    if(world.extent(0) == 0 || world.extent(1) == 0)
+    {
+        world.extend(geom::point(world.getMin()[0] - 0.5, world.getMin()[1] - 0.5));
+        world.extend(geom::point(world.getMax()[0] + 0.5, world.getMax()[1] + 0.5));
+    }
+
+    tree_.reset(new geom::LooseQuadtree(world, depth));
+    polylines_.reserve(count);
+
+    for(int i = 0; i < count; ++i)
+    {
+        const geom::Box<2> bounds = getBounds(i);
+
+        if(!bounds.isEmpty())
+        {
+            tree_->insert(bounds);
+            polylines_.push_back(i);
+        }
+    }
+}
+
+PolylineIndexWriter::PolylineIndexWriter(char const* path, unsigned long long fileSize, unsigned long long modificationTime)
+: out_(std::fopen(path, "wb")), count_(0), fileSize_(fileSize), modificationTime_(modificationTime), failed_(false)
+{
+    if(out_ == 0)
+    {
+        throw std::runtime_error(std::string("cannot create ") + path);
+    }
+
+    std::setvbuf(out_, 0, _IOFBF, kWriteBufferSize);
+
+    // The header is rewritten by close() once the count is known
+    PolylineIndexHeader header;
+
+    memset(&header, 0, sizeof(header));
+    failed_ = std::fwrite(&header, sizeof(header), 1, out_) != 1;
+}
+
+PolylineIndexWriter::~PolylineIndexWriter()
+{
+    if(out_ != 0)
+    {
+        try
+        {
+            close();
+        }
+        catch(std::exception const&)
+        {
+        }
+    }
+}
+
+void PolylineIndexWriter::add(unsigned long long offset, std::size_t pointCount, geom::Box<2> const& bounds)
+{
+    PolylineIndexEntry entry;
+
+    entry.offset = offset;
+    entry.pointCount = pointCount;
+
+    for(int i = 0; i < 2; ++i)
+    {
+        entry.min[i] = bounds.getMin()[i];
+        entry.max[i] = bounds.getMax()[i];
+    }
+
+    if(failed_ || std::fwrite(&entry, sizeof(entry), 1, out_) != 1)
+    {
+        failed_ = true;
+        throw std::runtime_error("polyline index write error");
+    }
+
+    ++count_;
+}
+
+void PolylineIndexWriter::close()
+{
+    PolylineIndexHeader header;
+
+    memcpy(header.magic, kMagic, sizeof(kMagic));
+    header.byteOrder = kByteOrder;
+    header.version = kVersion;
+    header.polylineCount = count_;
+    header.fileSize = fileSize_;
+    header.modificationTime = modificationTime_;
+
+    std::FILE* out = out_;
+    out_ = 0;
+
+    const bool failed = failed_
+        || std::fseek(out, 0, SEEK_SET) != 0
+        || std::fwrite(&header, sizeof(header), 1, out) != 1;
+
+    if(std::fclose(out) != 0 || failed)
+    {
+        throw std::runtime_error("polyline index write error");
+    }
+}
+
+} } // namespace util/simge
@@ -0,0 +1,197 @@
+/*
+ * Copyright (c) 2006 Emir UNER
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <simge/util/Scan.hpp>
+
+#include <string>
+#include <cstdlib>
+
+namespace
+{
+    // Powers of ten that are exactly representable as doubles.
+    const double kExactPowers[] =
+    {
+        1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+        1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+    };
+
+    const int kMaxExactPower = 22;
+
+    // Mantissas up to 2^53 are exact doubles.
+    const unsigned long long kMaxExactMantissa = 9007199254740992ULL;
+
+    /**
+     * Converts the token [begin, end) with strtod.
+     */
+    bool slowScan(char const* begin, char const* end, double& value)
+    {
+        char buf[64];
+        std::string longToken;
+        char const* str = buf;
+        const std::size_t len = end - begin;
+
+        if(len < sizeof(buf))
+        {
+            std::copy(begin, end, buf);
+            buf[len] = '\0';
+        }
+        else
+        {
+            longToken.assign(begin, end);
+            str = longToken.c_str();
+        }
+
+        char* parsed;
+        value = strtod(str, &parsed);
+
+        return parsed == str + len;
+    }
+
+} // namespace <unnamed>
+
+namespace simge { namespace util {
+
+bool scanDouble(char const*& cur, char const* end, double& value)
+{
+    char const* const start = skipSpace(cur, end);
+    char const* p = start;
+    bool negative = false;
+    unsigned long long mantissa = 0;
+    int digits = 0;
+    int exponent = 0;
+    bool anyDigit = false;
+
+    if(p != end && (*p == '-' || *p == '+'))
+    {
+        negative = *p == '-';
+        ++p;
+    }
+
+    // Leading zeros are not significant
+    while(p != end && *p == '0')
+    {
+        anyDigit = true;
+        ++p;
+    }
+
+    while(p != end && isDigit(*p))
+    {
+        if(digits < 19)
+        {
+            mantissa = mantissa * 10 + (*p - '0');
+        }
+        else
+        {
+            ++exponent;
+        }
+
+        ++digits;
+        anyDigit = true;
+        ++p;
+    }
+
+    if(p != end && *p == '.')
+    {
+        ++p;
+
+        if(digits == 0)
+        {
+            while(p != end && *p == '0')
+            {
+                anyDigit = true;
+                --exponent;
+                ++p;
+            }
+        }
+
+        while(p != end && isDigit(*p))
+        {
+            if(digits < 19)
+            {
+                mantissa = mantissa * 10 + (*p - '0');
+                --exponent;
+            }
+
+            ++digits;
+            anyDigit = true;
+            ++p;
+        }
+    }
+
+    if(!anyDigit)
+    {
+        return false;
+    }
+
+    if(p != end && (*p == 'e' || *p == 'E'))
+    {
+        char const* q = p + 1;
+        bool negativeExponent = false;
+
+        if(q != end && (*q == '-' || *q == '+'))
+        {
+            negativeExponent = *q == '-';
+            ++q;
+        }
+
+        // A lone 'e' is not part of the number
+        if(q != end && isDigit(*q))
+        {
+            int e = 0;
+
+            while(q != end && isDigit(*q))
+            {
+                if(e < 100000)
+                {
+                    e = e * 10 + (*q - '0');
+                }
+
+                ++q;
+            }
+
+            exponent += negativeExponent ? -e : e;
+            p = q;
+        }
+    }
+
+    if(digits <= 19 && mantissa <= kMaxExactMantissa
+       && exponent >= -kMaxExactPower && exponent <= kMaxExactPower)
+    {
+        const double m = static_cast<double>(mantissa);
+        const double result = exponent < 0 ? m / kExactPowers[-exponent] : m * kExactPowers[exponent];
+
+        value = negative ? -result : result;
+        cur = p;
+
+        return true;
+    }
+
+    if(slowScan(start, p, value))
+    {
+        cur = p;
+        return true;
+    }
+
+    return false;
+}
+
+} } // namespace util/simge
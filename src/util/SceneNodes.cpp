@@ -0,0 +1,120 @@
+/*
+ * Copyright (c) 2006 Emir UNER
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <simge/util/SceneNodes.hpp>
+#include <simge/util/Utility.hpp>
+
+namespace simge { namespace util {
+
+PolygonNode::PolygonNode(geom::Polygon<2> const& polygon, Color const& color)
+: polygon_(polygon), color_(color)
+{
+}
+
+void PolygonNode::setPolygon(geom::Polygon<2> const& polygon)
+{
+    polygon_ = polygon;
+    markDirty();
+}
+
+void PolygonNode::setColor(Color const& color)
+{
+    color_ = color;
+    markDirty();
+}
+
+geom::Box<2> PolygonNode::getBounds() const
+{
+    return polygon_.getBounds();
+}
+
+void PolygonNode::render()
+{
+    color(color_);
+    drawLineLoop(polygon_);
+}
+
+CircleNode::CircleNode(geom::Point<2> const& center, double radius, Color const& color, int approx)
+: center_(center), radius_(radius), color_(color), approx_(approx)
+{
+}
+
+void CircleNode::setCircle(geom::Point<2> const& center, double radius)
+{
+    center_ = center;
+    radius_ = radius;
+    markDirty();
+}
+
+void CircleNode::setColor(Color const& color)
+{
+    color_ = color;
+    markDirty();
+}
+
+geom::Box<2> CircleNode::getBounds() const
+{
+    return geom::box(geom::point(center_[0] - radius_, center_[1] - radius_),
+                     geom::point(center_[0] + radius_, center_[1] + radius_));
+}
+
+void CircleNode::render()
+{
+    color(color_);
+    drawCircle(center_, radius_, approx_);
+}
+
+TextNode::TextNode(void* font, geom::Point<2> const& pos, char const* text, Color const& color)
+: font_(font), pos_(pos), text_(text), color_(color)
+{
+}
+
+void TextNode::setText(char const* text)
+{
+    text_ = text;
+    markDirty();
+}
+
+void TextNode::setPosition(geom::Point<2> const& pos)
+{
+    pos_ = pos;
+    markDirty();
+}
+
+void TextNode::setColor(Color const& color)
+{
+    color_ = color;
+    markDirty();
+}
+
+void TextNode::prepare()
+{
+    glyphCache(font_);
+}
+
+void TextNode::render()
+{
+    color(color_);
+    drawText(font_, pos_, text_.c_str());
+}
+
+} } // namespace util/simge
@@ -0,0 +1,267 @@
+/*
+ * Copyright (c) 2006 Emir UNER
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+// glWindowPos is OpenGL 1.4
+#define GL_GLEXT_PROTOTYPES
+
+#include <simge/util/TextRenderer.hpp>
+#include <simge/glut/Point.hpp>
+#include <simge/glut/Window.hpp>
+
+#include <cstring>
+#include <map>
+
+namespace
+{
+    const int kGlyphCount = 256;
+
+    typedef std::map<std::pair<int, void*>, simge::util::GlyphCache*> GlyphCacheMap;
+
+    GlyphCacheMap glyphCaches;
+
+    /**
+     * Drops the caches of a destroyed window. Its lists are left to the
+     * window's context, the window may not be valid any more.
+     */
+    void releaseGlyphCaches(int window)
+    {
+        GlyphCacheMap::iterator it = glyphCaches.lower_bound(std::make_pair(window, static_cast<void*>(0)));
+
+        while(it != glyphCaches.end() && it->first.first == window)
+        {
+            it->second->abandon();
+            delete it->second;
+            glyphCaches.erase(it++);
+        }
+    }
+
+    /**
+     * Maps object coordinates to window coordinates the way the raster
+     * position does, but keeps the points outside of the viewport.
+     */
+    class WindowProjection
+    {
+    public:
+        /**
+         * Reads the matrices, viewport and depth range of the current window.
+         */
+        WindowProjection()
+        {
+            glGetDoublev(GL_MODELVIEW_MATRIX, modelview_);
+            glGetDoublev(GL_PROJECTION_MATRIX, projection_);
+            glGetIntegerv(GL_VIEWPORT, viewport_);
+            glGetDoublev(GL_DEPTH_RANGE, depthRange_);
+        }
+
+        /**
+         * Window coordinates of p. Returns false if p is clipped
+         * by the near or far plane.
+         */
+        bool project(simge::geom::Point<3> const& p, double window[3]) const
+        {
+            double eye[4];
+            double clip[4];
+
+            transform(modelview_, p[0], p[1], p[2], 1, eye);
+            transform(projection_, eye[0], eye[1], eye[2], eye[3], clip);
+
+            if(clip[3] <= 0 || clip[2] < -clip[3] || clip[2] > clip[3])
+            {
+                return false;
+            }
+
+            window[0] = viewport_[0] + (clip[0] / clip[3] + 1) * viewport_[2] / 2;
+            window[1] = viewport_[1] + (clip[1] / clip[3] + 1) * viewport_[3] / 2;
+            window[2] = depthRange_[0] + (clip[2] / clip[3] + 1) * (depthRange_[1] - depthRange_[0]) / 2;
+
+            return true;
+        }
+
+    private:
+        // Matrices are column major
+        static void transform(GLdouble const m[16], double x, double y, double z, double w, double out[4])
+        {
+            for(int i = 0; i < 4; ++i)
+            {
+                out[i] = m[i] * x + m[4 + i] * y + m[8 + i] * z + m[12 + i] * w;
+            }
+        }
+
+        GLdouble modelview_[16];
+        GLdouble projection_[16];
+        GLint viewport_[4];
+        GLdouble depthRange_[2];
+    };
+}
+
+namespace simge { namespace util {
+
+GlyphCache::GlyphCache(void* font)
+: font_(font), base_(0)
+{
+}
+
+GlyphCache::~GlyphCache()
+{
+    if(base_ != 0)
+    {
+        glDeleteLists(base_, kGlyphCount);
+    }
+}
+
+void GlyphCache::build()
+{
+    if(base_ != 0)
+    {
+        return;
+    }
+
+    base_ = glGenLists(kGlyphCount);
+
+    for(int ch = 0; ch < kGlyphCount; ++ch)
+    {
+        glNewList(base_ + ch, GL_COMPILE);
+        glutBitmapCharacter(font_, ch);
+        glEndList();
+    }
+}
+
+void GlyphCache::loadWidths()
+{
+    widths_.resize(kGlyphCount);
+
+    for(int ch = 0; ch < kGlyphCount; ++ch)
+    {
+        widths_[ch] = glutBitmapWidth(font_, ch);
+    }
+}
+
+void GlyphCache::abandon()
+{
+    base_ = 0;
+}
+
+void GlyphCache::draw(geom::Point<3> const& pos, char const* str, int len)
+{
+    build();
+    glut::rasterPos(pos);
+
+    glPushAttrib(GL_LIST_BIT);
+    glListBase(base_);
+    glCallLists(len, GL_UNSIGNED_BYTE, str);
+    glPopAttrib();
+}
+
+void GlyphCache::draw(geom::Point<3> const& pos, char const* str)
+{
+    draw(pos, str, strlen(str));
+}
+
+int GlyphCache::getWidth(char const* str, int len)
+{
+    if(widths_.empty())
+    {
+        loadWidths();
+    }
+
+    int width = 0;
+
+    for(int i = 0; i < len; ++i)
+    {
+        width += widths_[static_cast<unsigned char>(str[i])];
+    }
+
+    return width;
+}
+
+GlyphCache& glyphCache(void* font)
+{
+    static bool listening = false;
+
+    if(!listening)
+    {
+        glut::Window::addDestroyListener(&releaseGlyphCaches);
+        listening = true;
+    }
+
+    GlyphCache*& cache = glyphCaches[std::make_pair(glutGetWindow(), font)];
+
+    if(cache == 0)
+    {
+        cache = new GlyphCache(font);
+        cache->build();
+    }
+
+    return *cache;
+}
+
+TextBatch::TextBatch(GlyphCache& cache)
+: cache_(cache)
+{
+}
+
+void TextBatch::add(geom::Point<2> const& pos, char const* str)
+{
+    Label label;
+
+    label.pos = pos;
+    label.first = chars_.size();
+    label.count = strlen(str);
+
+    chars_.insert(chars_.end(), str, str + label.count);
+    labels_.push_back(label);
+}
+
+void TextBatch::clear()
+{
+    chars_.clear();
+    labels_.clear();
+}
+
+void TextBatch::draw()
+{
+    if(labels_.empty())
+    {
+        return;
+    }
+
+    cache_.build();
+
+    const WindowProjection projection;
+    double window[3];
+
+    glPushAttrib(GL_LIST_BIT);
+    glListBase(cache_.base_);
+
+    for(std::vector<Label>::const_iterator it = labels_.begin(); it != labels_.end(); ++it)
+    {
+        if(projection.project(geom::Point<3>(it->pos), window))
+        {
+            glWindowPos3dv(window);
+            glCallLists(it->count, GL_UNSIGNED_BYTE, &chars_[it->first]);
+        }
+    }
+
+    glPopAttrib();
+}
+
+} } // namespace util/simge
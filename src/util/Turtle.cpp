@@ -32,14 +32,14 @@ namespace simge { namespace util {
 using namespace geom;
     
 Turtle::Turtle()
-: tail_(Color::red()), angle_(0)
+: tail_(Color::red()), angle_(0), recording_(false)
 {
     pos_[0] = 0;
     pos_[1] = 0;
 }
 
 Turtle::Turtle(Point<2> const& pos, Color const& color)
-: tail_(color), pos_(pos)
+: tail_(color), angle_(0), pos_(pos), recording_(false)
 {
 }
 
@@ -55,10 +55,7 @@ void Turtle::moveTo(Point<2> const& pos)
     
 void Turtle::lineTo(Point<2> const& pos)
 {
-    glBegin(GL_LINES);
-    glut::vertex(pos_);
-    glut::vertex(pos);
-    glEnd();
+    segment(pos_, pos);
     pos_ = pos;
 }
 
@@ -70,12 +67,11 @@ void Turtle::moveRel(double dx, double dy)
 
 void Turtle::lineRel(double dx, double dy)
 {
-    glBegin(GL_LINES);
-    glut::vertex(pos_);
+    const Point<2> from = pos_;
+
     pos_[0] += dx;
     pos_[1] += dy;
-    glut::vertex(pos_);
-    glEnd();    
+    segment(from, pos_);
 }   
 
 void Turtle::turn(double diff)
@@ -123,4 +119,105 @@ void Turtle::forward(double dist, bool isVisible)
     }
 }
 
+void Turtle::segment(Point<2> const& from, Point<2> const& to)
+{
+    if(!recording_)
+    {
+        glBegin(GL_LINES);
+        glut::vertex(from);
+        glut::vertex(to);
+        glEnd();
+        return;
+    }
+
+    vertexes_.push_back(from[0]);
+    vertexes_.push_back(from[1]);
+    vertexes_.push_back(to[0]);
+    vertexes_.push_back(to[1]);
+
+    for(int i = 0; i < 2; ++i)
+    {
+        colors_.push_back(tail_.r);
+        colors_.push_back(tail_.g);
+        colors_.push_back(tail_.b);
+    }
+}
+
+void Turtle::setRecording(bool recording)
+{
+    recording_ = recording;
+}
+
+void Turtle::flush()
+{
+    if(vertexes_.empty())
+    {
+        return;
+    }
+
+    // The current color is undefined after drawing with a color array
+    glPushAttrib(GL_CURRENT_BIT);
+    glPushClientAttrib(GL_CLIENT_VERTEX_ARRAY_BIT);
+    glEnableClientState(GL_VERTEX_ARRAY);
+    glEnableClientState(GL_COLOR_ARRAY);
+    glVertexPointer(2, GL_DOUBLE, 0, &vertexes_[0]);
+    glColorPointer(3, GL_UNSIGNED_SHORT, 0, &colors_[0]);
+    glDrawArrays(GL_LINES, 0, vertexes_.size() / 2);
+    glPopClientAttrib();
+    glPopAttrib();
+
+    clearRecording();
+}
+
+void Turtle::clearRecording()
+{
+    vertexes_.clear();
+    colors_.clear();
+}
+
+void Turtle::exportPolylines(std::vector<Polyline<Point<2> > >& lines) const
+{
+    const std::size_t count = getSegmentCount();
+    Polyline<Point<2> >* line = 0;
+
+    for(std::size_t i = 0; i < count; ++i)
+    {
+        double const* v = &vertexes_[4 * i];
+        GLushort const* c = &colors_[6 * i];
+        const Color color(c[0], c[1], c[2]);
+
+        if(line == 0 || color != line->color
+           || line->points.back()[0] != v[0] || line->points.back()[1] != v[1])
+        {
+            lines.push_back(Polyline<Point<2> >());
+            line = &lines.back();
+            line->color = color;
+            line->points.push_back(point(v[0], v[1]));
+        }
+
+        line->points.push_back(point(v[2], v[3]));
+    }
+}
+
+void Turtle::transformRecording(Vector<2> const& offset, double angle)
+{
+    const double c = cos(degreeToRadian(angle));
+    const double s = sin(degreeToRadian(angle));
+
+    for(std::vector<double>::iterator it = vertexes_.begin(); it != vertexes_.end(); it += 2)
+    {
+        const double x = it[0];
+        const double y = it[1];
+
+        it[0] = c * x - s * y + offset[0];
+        it[1] = s * x + c * y + offset[1];
+    }
+}
+
+void Turtle::appendRecording(Turtle const& other)
+{
+    vertexes_.insert(vertexes_.end(), other.vertexes_.begin(), other.vertexes_.end());
+    colors_.insert(colors_.end(), other.colors_.begin(), other.colors_.end());
+}
+
 } } // namespace simge/util
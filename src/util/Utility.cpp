@@ -20,8 +20,79 @@
  * SOFTWARE.
  */
 
+// glMultiDrawArrays is part of OpenGL 1.4 but the headers only declare it
+// when asked to.
+#define GL_GLEXT_PROTOTYPES
+
 #include <simge/util/Utility.hpp>
 
+#include <cmath>
+#include <map>
+#include <vector>
+
+namespace
+{
+    const double kPi2 = 6.28318530717958647688;
+
+    // Level of detail limits for drawCircles
+    const double kMaxCircleError = 0.5;
+    const int kMinCircleApprox = 8;
+    const int kMaxCircleApprox = 256;
+
+    typedef std::vector<double> UnitCircle;
+    typedef std::map<int, UnitCircle> UnitCircleMap;
+
+    UnitCircleMap unitCircles;
+
+    /**
+     * Returns approx points on the unit circle as x, y pairs, computed
+     * once per approx.
+     */
+    UnitCircle const& unitCircle(int approx)
+    {
+        UnitCircle& circle = unitCircles[approx];
+
+        if(circle.empty())
+        {
+            const double step = kPi2 / approx;
+
+            circle.resize(2 * approx);
+
+            for(int i = 0; i < approx; ++i)
+            {
+                circle[2 * i] = cos(step * i);
+                circle[2 * i + 1] = sin(step * i);
+            }
+        }
+
+        return circle;
+    }
+
+    /**
+     * The least approx, rounded up to a multiple of 8, for which the
+     * n-gon stays within kMaxCircleError of a circle of the given radius.
+     */
+    int circleApprox(double radius)
+    {
+        // Also catches NaN radii
+        if(!(radius > kMaxCircleError))
+        {
+            return kMinCircleApprox;
+        }
+
+        const int n = static_cast<int>(ceil(kPi2 / 2 / acos(1 - kMaxCircleError / radius)));
+        const int rounded = (n + 7) / 8 * 8;
+
+        return rounded < kMinCircleApprox ? kMinCircleApprox
+            : (rounded > kMaxCircleApprox ? kMaxCircleApprox : rounded);
+    }
+
+    // Reused by drawCircles
+    std::vector<double> circleVertexes;
+    std::vector<GLint> circleFirsts;
+    std::vector<GLsizei> circleCounts;
+}
+
 namespace simge { namespace util {
 
 using namespace glut;
@@ -56,23 +127,57 @@ void drawCross(Point<2> const& pos, int size)
 
 void drawCircle(Point<2> const& center, double radius, int approx)
 {
-    const double kPi2 = 6.28318530717958647688;
-    const double kPi2DivApprox = kPi2 / approx;
-    
-    const Vector<2> shifter = center - point(0, 0);
-    Point<2> last = shifter + point(radius, 0);
+    if(approx <= 0)
+    {
+        return;
+    }
+
+    UnitCircle const& circle = unitCircle(approx);
     
     glBegin(GL_LINE_LOOP);
     for(int i = 0; i < approx; ++i)
     {
-        vertex(last);
-        last = shifter + point(radius * cos(kPi2DivApprox * i),
-                               radius * sin(kPi2DivApprox * i));
-        vertex(last);
+        glVertex2d(center[0] + radius * circle[2 * i], center[1] + radius * circle[2 * i + 1]);
     }
     glEnd();
 }
 
+void drawCircles(Point<2> const* centers, double const* radii, int count, double scale, int approx)
+{
+    if(count <= 0 || (scale <= 0 && approx <= 0))
+    {
+        return;
+    }
+
+    circleVertexes.clear();
+    circleFirsts.resize(count);
+    circleCounts.resize(count);
+
+    for(int i = 0; i < count; ++i)
+    {
+        const int n = scale > 0 ? circleApprox(radii[i] * scale) : approx;
+        UnitCircle const& circle = unitCircle(n);
+        const double x = centers[i][0];
+        const double y = centers[i][1];
+        const double r = radii[i];
+
+        circleFirsts[i] = circleVertexes.size() / 2;
+        circleCounts[i] = n;
+
+        for(int j = 0; j < 2 * n; j += 2)
+        {
+            circleVertexes.push_back(x + r * circle[j]);
+            circleVertexes.push_back(y + r * circle[j + 1]);
+        }
+    }
+
+    glPushClientAttrib(GL_CLIENT_VERTEX_ARRAY_BIT);
+    glEnableClientState(GL_VERTEX_ARRAY);
+    glVertexPointer(2, GL_DOUBLE, 0, &circleVertexes[0]);
+    glMultiDrawArrays(GL_LINE_LOOP, &circleFirsts[0], &circleCounts[0], count);
+    glPopClientAttrib();
+}
+
 void drawGrabHandle(Point<2> const& pos, double size)
 {
     const double x = pos[0];
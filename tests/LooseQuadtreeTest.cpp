@@ -0,0 +1,123 @@
+/*
+ * Copyright (c) 2006 Emir UNER
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <iostream>
+#include <vector>
+
+#include <simge/geom/LooseQuadtree.hpp>
+
+using namespace simge::geom;
+
+namespace
+{
+    int failures = 0;
+
+    void check(bool condition, char const* what)
+    {
+        if(!condition)
+        {
+            std::cerr << "FAILED: " << what << std::endl;
+            ++failures;
+        }
+    }
+
+    Box<2> square(double x, double y, double size)
+    {
+        return Box<2>(point(x, y), point(x + size, y + size));
+    }
+
+    bool found(LooseQuadtree const& tree, Box<2> const& area, int id)
+    {
+        std::vector<int> ids;
+
+        tree.query(area, ids);
+
+        for(std::vector<int>::const_iterator it = ids.begin(); it != ids.end(); ++it)
+        {
+            if(*it == id)
+            {
+                return true;
+            }
+        }
+
+        return false;
+    }
+
+    void testMoveOutOfWorldAndBack()
+    {
+        LooseQuadtree tree(square(0, 0, 100), 4);
+        const int id = tree.insert(square(10, 10, 1));
+
+        check(tree.getDepth(id) == 4, "small object is stored at the deepest level");
+
+        tree.move(id, square(500, 500, 1));
+        check(tree.getDepth(id) == 0, "object outside of the world is stored at the root");
+        check(found(tree, square(499, 499, 3), id), "object outside of the world is found");
+
+        tree.move(id, square(80, 80, 1));
+        check(tree.getDepth(id) == 4, "object moved back into the world leaves the root");
+        check(found(tree, square(79, 79, 3), id), "object moved back into the world is found");
+        check(!found(tree, square(499, 499, 3), id), "object is not found at its old place");
+    }
+
+    void testShrinkMovesDown()
+    {
+        LooseQuadtree tree(square(0, 0, 100), 4);
+        const int id = tree.insert(square(10, 10, 60));
+
+        check(tree.getDepth(id) == 0, "large object is stored at the root");
+
+        tree.move(id, square(10, 10, 1));
+        check(tree.getDepth(id) == 4, "shrunk object moves down to a child");
+
+        tree.move(id, square(30, 30, 40));
+        check(tree.getDepth(id) == 1, "grown object moves up");
+        check(found(tree, square(60, 60, 1), id), "grown object is found");
+    }
+
+    void testBatchedMove()
+    {
+        LooseQuadtree tree(square(0, 0, 100), 4);
+        std::vector<LooseQuadtree::Move> moves;
+        const int first = tree.insert(square(200, 200, 1));
+        const int second = tree.insert(square(5, 5, 1));
+
+        moves.push_back(LooseQuadtree::Move(first, square(50, 50, 1)));
+        moves.push_back(LooseQuadtree::Move(second, square(-50, -50, 1)));
+        tree.move(moves);
+
+        check(tree.getDepth(first) == 4, "batched move takes an object out of the root");
+        check(tree.getDepth(second) == 0, "batched move takes an object out of the world");
+        check(found(tree, square(50, 50, 1), first), "first object is found after the batched move");
+        check(found(tree, square(-50, -50, 1), second), "second object is found after the batched move");
+        check(tree.size() == 2, "batched move keeps the object count");
+    }
+}
+
+int main()
+{
+    testMoveOutOfWorldAndBack();
+    testShrinkMovesDown();
+    testBatchedMove();
+
+    return failures == 0 ? 0 : 1;
+}
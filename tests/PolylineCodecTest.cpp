@@ -0,0 +1,365 @@
+/*
+ * Copyright (c) 2006 Emir UNER
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <climits>
+#include <iostream>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <simge/util/PolylineCodec.hpp>
+
+using namespace simge::geom;
+using namespace simge::util;
+
+namespace
+{
+    int failures = 0;
+
+    void check(bool condition, char const* what)
+    {
+        if(!condition)
+        {
+            std::cerr << "FAILED: " << what << std::endl;
+            ++failures;
+        }
+    }
+
+    typedef std::vector<unsigned char> ByteVec;
+
+    /**
+     * Exact comparison, Point's operator== has a tolerance.
+     */
+    template <int Dim>
+    bool samePoints(std::vector<Point<Dim> > const& lhs, std::vector<Point<Dim> > const& rhs)
+    {
+        if(lhs.size() != rhs.size())
+        {
+            return false;
+        }
+
+        for(std::size_t i = 0; i < lhs.size(); ++i)
+        {
+            for(int d = 0; d < Dim; ++d)
+            {
+                if(lhs[i][d] != rhs[i][d])
+                {
+                    return false;
+                }
+            }
+        }
+
+        return true;
+    }
+
+    Polyline<Point<2> > zigzagLine()
+    {
+        Polyline<Point<2> > line;
+
+        line.color = Color(0x1234, 0xabcd, 0xff00);
+
+        for(int i = 0; i < 100; ++i)
+        {
+            line.points.push_back(point(i * 0.25 - 10, (i % 2 == 0 ? 1e6 : -1e6) + i * 0.5));
+        }
+
+        return line;
+    }
+
+    bool decodeThrows(ByteVec const& data, std::size_t count)
+    {
+        std::vector<double> out(2 * count + 2);
+
+        try
+        {
+            decodePoints(data.data(), data.data() + data.size(), count, 2, 1, out.data());
+        }
+        catch(std::runtime_error const&)
+        {
+            return true;
+        }
+
+        return false;
+    }
+
+    bool decompressThrows(CompressedPolyline<Point<2> > const& line)
+    {
+        Polyline<Point<2> > result;
+
+        try
+        {
+            decompress(line, result);
+        }
+        catch(std::runtime_error const&)
+        {
+            return true;
+        }
+
+        return false;
+    }
+
+    bool readThrows(std::string const& bytes)
+    {
+        std::istringstream in(bytes);
+
+        try
+        {
+            CompressedPolylineFile<Point<2> > file(in);
+
+            for(int i = 0; i < file.getPolylineCount(); ++i)
+            {
+                file.getNext();
+            }
+        }
+        catch(std::runtime_error const&)
+        {
+            return true;
+        }
+
+        return false;
+    }
+
+    std::string writeFile(Polyline<Point<2> > const& line, int count)
+    {
+        std::ostringstream out;
+        CompressedPolylineWriter<Point<2> > writer(out, count, 0.25);
+
+        for(int i = 0; i < count; ++i)
+        {
+            writer.write(line);
+        }
+
+        return out.str();
+    }
+
+    void testZigzag()
+    {
+        const long long values[] = { 0, 1, -1, 63, -64, 64, LLONG_MAX, LLONG_MIN };
+
+        check(zigzag(0) == 0 && zigzag(-1) == 1 && zigzag(1) == 2 && zigzag(-2) == 3,
+              "zigzag interleaves signs");
+        check(zigzag(LLONG_MIN) == ULLONG_MAX, "zigzag of the smallest value is the largest code");
+
+        for(std::size_t i = 0; i < sizeof(values) / sizeof(values[0]); ++i)
+        {
+            check(unzigzag(zigzag(values[i])) == values[i], "zigzag round-trip");
+        }
+    }
+
+    void testVarint()
+    {
+        const unsigned long long values[] = { 0, 1, 127, 128, 16383, 16384, 1ULL << 63, ULLONG_MAX };
+        unsigned char buf[16];
+
+        for(std::size_t i = 0; i < sizeof(values) / sizeof(values[0]); ++i)
+        {
+            unsigned char* const end = putVarint(buf, values[i]);
+            unsigned char const* cur = buf;
+            unsigned long long value = 0;
+
+            check(getVarint(cur, end, value) && value == values[i] && cur == end, "varint round-trip");
+
+            cur = buf;
+            check(!getVarint(cur, end - 1, value) && cur == buf, "truncated varint is rejected");
+        }
+
+        check(putVarint(buf, 127) - buf == 1 && putVarint(buf, 128) - buf == 2, "varint lengths");
+        check(putVarint(buf, ULLONG_MAX) - buf == 10, "varints take at most 10 bytes");
+
+        // Eleven bytes with the continuation bit never end within 64 bits
+        ByteVec overlong(11, 0x80);
+        unsigned char const* cur = overlong.data();
+        unsigned long long value;
+
+        overlong.back() = 0;
+        check(!getVarint(cur, overlong.data() + overlong.size(), value), "overlong varint is rejected");
+    }
+
+    void testDelta()
+    {
+        const Polyline<Point<2> > line = zigzagLine();
+        CompressedPolyline<Point<2> > compressed;
+        Polyline<Point<2> > result;
+
+        compress(line, 0.25, compressed);
+        decompress(compressed, result);
+
+        check(samePoints(result.points, line.points), "points on the resolution grid round-trip exactly");
+        check(!(result.color != line.color), "color round-trips");
+        check(compressed.data.size() < 100 * 2 * 5, "deltas are smaller than the coordinates");
+
+        // Rounding to the resolution
+        Polyline<Point<2> > rough;
+
+        rough.points.push_back(point(0.3, -0.3));
+        rough.points.push_back(point(1.13, 7.9));
+        compress(rough, 0.25, compressed);
+        decompress(compressed, result);
+
+        rough.points[0] = point(0.25, -0.25);
+        rough.points[1] = point(1.25, 8);
+        check(samePoints(result.points, rough.points), "points are rounded to the resolution");
+
+        // Three dimensions
+        Polyline<Point<3> > line3;
+        CompressedPolyline<Point<3> > compressed3;
+        Polyline<Point<3> > result3;
+        Point<3> p;
+
+        for(int i = 0; i < 10; ++i)
+        {
+            p[0] = i;
+            p[1] = -2 * i;
+            p[2] = i * i;
+            line3.points.push_back(p);
+        }
+
+        compress(line3, 1, compressed3);
+        decompress(compressed3, result3);
+        check(samePoints(result3.points, line3.points), "three dimensional round-trip");
+
+        // Empty
+        compress(Polyline<Point<2> >(), 1, compressed);
+        decompress(compressed, result);
+        check(compressed.data.empty() && result.points.empty(), "empty polyline round-trip");
+
+        bool thrown = false;
+
+        try
+        {
+            rough.points[1] = point(1e300, 0);
+            compress(rough, 0.25, compressed);
+        }
+        catch(std::runtime_error const&)
+        {
+            thrown = true;
+        }
+
+        check(thrown, "coordinates too large for the resolution are rejected");
+    }
+
+    void testCorruptData()
+    {
+        CompressedPolyline<Point<2> > compressed;
+
+        compress(zigzagLine(), 0.25, compressed);
+
+        ByteVec data = compressed.data;
+
+        check(decodeThrows(ByteVec(data.begin(), data.end() - 1), 100), "truncated data is rejected");
+        check(decodeThrows(ByteVec(), 1), "missing data is rejected");
+
+        // A varint longer than 10 bytes in the middle of the data
+        data.insert(data.begin() + 2, 12, 0x81);
+        check(decodeThrows(data, 100), "overlong varint in the data is rejected");
+
+        CompressedPolyline<Point<2> > corrupt = compressed;
+
+        corrupt.count = 1000000000;
+        check(decompressThrows(corrupt), "count larger than the data is rejected");
+
+        corrupt = compressed;
+        corrupt.count = 99;
+        check(decompressThrows(corrupt), "data left after the points is rejected");
+
+        corrupt = compressed;
+        corrupt.data.push_back(0);
+        check(decompressThrows(corrupt), "trailing byte is rejected");
+    }
+
+    void testFile()
+    {
+        const Polyline<Point<2> > line = zigzagLine();
+        const std::string bytes = writeFile(line, 3);
+        std::istringstream in(bytes);
+        CompressedPolylineFile<Point<2> > file(in);
+
+        check(file.getPolylineCount() == 3 && file.getResolution() == 0.25, "header round-trip");
+
+        for(int i = 0; i < 3; ++i)
+        {
+            const Polyline<Point<2> > result = file.getNext();
+
+            check(samePoints(result.points, line.points) && !(result.color != line.color), "file round-trip");
+        }
+
+        check(!readThrows(bytes), "correct file is read");
+        check(readThrows(bytes.substr(0, bytes.size() - 1)), "truncated file is rejected");
+        check(readThrows("X" + bytes.substr(1)), "bad magic is rejected");
+        check(readThrows(""), "empty file is rejected");
+
+        // Header with one polyline of 2^40 points in a 4 byte record
+        std::string huge = writeFile(Polyline<Point<2> >(), 1);
+        unsigned char record[16];
+        unsigned char* cur = record;
+
+        huge.resize(huge.size() - 5);
+        cur = putVarint(cur, 1ULL << 40);
+        cur = putVarint(cur, 0);
+        cur = putVarint(cur, 0);
+        cur = putVarint(cur, 0);
+        cur = putVarint(cur, 4);
+        huge.append(reinterpret_cast<char const*>(record), cur - record);
+        huge.append(4, '\0');
+        check(readThrows(huge), "point count larger than the record is rejected");
+
+        // Record claiming more than 1 GiB
+        std::string large = writeFile(Polyline<Point<2> >(), 1);
+
+        cur = record;
+        large.resize(large.size() - 5);
+        cur = putVarint(cur, 1);
+        cur = putVarint(cur, 0);
+        cur = putVarint(cur, 0);
+        cur = putVarint(cur, 0);
+        cur = putVarint(cur, 1ULL << 40);
+        large.append(reinterpret_cast<char const*>(record), cur - record);
+        check(readThrows(large), "record size over the limit is rejected");
+
+        // Record size larger than the rest of the file
+        std::string shortRecord = writeFile(Polyline<Point<2> >(), 1);
+
+        cur = record;
+        shortRecord.resize(shortRecord.size() - 5);
+        cur = putVarint(cur, 1);
+        cur = putVarint(cur, 0);
+        cur = putVarint(cur, 0);
+        cur = putVarint(cur, 0);
+        cur = putVarint(cur, 1000);
+        shortRecord.append(reinterpret_cast<char const*>(record), cur - record);
+        shortRecord.append(10, '\0');
+        check(readThrows(shortRecord), "record size larger than the file is rejected");
+    }
+
+} // namespace <unnamed>
+
+int main()
+{
+    testZigzag();
+    testVarint();
+    testDelta();
+    testCorruptData();
+    testFile();
+
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,560 @@
+/*
+ * Copyright (c) 2006 Emir UNER
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <simge/util/BinaryPolylineFile.hpp>
+#include <simge/util/MappedPolylineFile.hpp>
+#include <simge/util/ParallelPolylineFile.hpp>
+#include <simge/util/PolylineFile.hpp>
+#include <simge/util/PolylineIndex.hpp>
+#include <simge/util/PolylineWriter.hpp>
+
+using namespace simge::geom;
+using namespace simge::util;
+
+namespace
+{
+    int failures = 0;
+
+    void check(bool condition, char const* what)
+    {
+        if(!condition)
+        {
+            std::cerr << "FAILED: " << what << std::endl;
+            ++failures;
+        }
+    }
+
+    typedef Polyline<Point<2> > Line;
+    typedef std::vector<Line> LineVec;
+
+    char const* const kTextPath = "PolylineFileTest.txt";
+    char const* const kIndexPath = "PolylineFileTest.idx";
+    char const* const kBinaryPath = "PolylineFileTest.bin";
+
+    /**
+     * Same sequence on every platform, unlike rand().
+     */
+    class Random
+    {
+    public:
+        explicit Random(unsigned long long seed)
+        : state_(seed)
+        {
+        }
+
+        double next()
+        {
+            state_ = state_ * 6364136223846793005ULL + 1442695040888963407ULL;
+
+            return static_cast<double>(state_ >> 11) / 4503599627370496.0 - 1;
+        }
+
+    private:
+        unsigned long long state_;
+    };
+
+    /**
+     * Polylines of random lengths, some empty, placed on a 10 by 10 grid
+     * of cells, with colors that need all four hex digits.
+     */
+    LineVec randomLines(int count, unsigned long long seed)
+    {
+        Random random(seed);
+        LineVec lines(count);
+
+        for(int i = 0; i < count; ++i)
+        {
+            const int pointCount = static_cast<int>((random.next() + 1) * 20) - 5;
+            const double x = (i % 10) * 10;
+            const double y = (i / 10 % 10) * 10;
+
+            for(int j = 0; j < pointCount; ++j)
+            {
+                lines[i].points.push_back(point(x + 4 + 4 * random.next(), y + 4 + 4 * random.next()));
+            }
+
+            lines[i].color = i % 3 == 0 ? Color::black() : Color(0x1234 + i, 0xabcd, 0x0f0f);
+        }
+
+        return lines;
+    }
+
+    void writeText(LineVec const& lines)
+    {
+        std::ofstream out(kTextPath, std::ios::binary);
+        PolylineWriter<Point<2> > writer(out, lines.size(), 256);
+
+        for(LineVec::const_iterator it = lines.begin(); it != lines.end(); ++it)
+        {
+            writer.write(*it);
+        }
+
+        writer.close();
+    }
+
+    void writeFile(char const* path, char const* text)
+    {
+        std::ofstream out(path, std::ios::binary);
+
+        out << text;
+    }
+
+    /**
+     * Exact comparison, Point's operator== has a tolerance.
+     */
+    bool samePoint(Point<2> const& lhs, Point<2> const& rhs)
+    {
+        return lhs[0] == rhs[0] && lhs[1] == rhs[1];
+    }
+
+    bool samePoints(Line::PointVec const& lhs, Line::PointVec const& rhs)
+    {
+        return lhs.size() == rhs.size() && std::equal(lhs.begin(), lhs.end(), rhs.begin(), &samePoint);
+    }
+
+    bool sameLine(Line const& expected, Point<2> const* begin, Point<2> const* end, Color const& color)
+    {
+        return static_cast<std::size_t>(end - begin) == expected.points.size() &&
+            std::equal(begin, end, expected.points.begin(), &samePoint) && !(color != expected.color);
+    }
+
+    bool sameLines(LineVec const& expected, PolylineArena<Point<2> > const& arena)
+    {
+        if(arena.size() != static_cast<int>(expected.size()))
+        {
+            return false;
+        }
+
+        for(int i = 0; i < arena.size(); ++i)
+        {
+            if(!sameLine(expected[i], arena.begin(i), arena.end(i), arena.lines[i].color))
+            {
+                return false;
+            }
+        }
+
+        return true;
+    }
+
+    bool sameArenas(PolylineArena<Point<2> > const& lhs, PolylineArena<Point<2> > const& rhs)
+    {
+        if(lhs.size() != rhs.size())
+        {
+            return false;
+        }
+
+        for(int i = 0; i < lhs.size(); ++i)
+        {
+            if(lhs.lines[i].count != rhs.lines[i].count || lhs.lines[i].color != rhs.lines[i].color ||
+               !std::equal(lhs.begin(i), lhs.end(i), rhs.begin(i), &samePoint))
+            {
+                return false;
+            }
+        }
+
+        return true;
+    }
+
+    bool mappedThrows(char const* text)
+    {
+        writeFile(kTextPath, text);
+
+        try
+        {
+            MappedPolylineFile<Point<2> > in(kTextPath);
+            PolylineArena<Point<2> > arena;
+
+            in.readAll(arena);
+        }
+        catch(std::runtime_error const&)
+        {
+            return true;
+        }
+
+        return false;
+    }
+
+    bool parallelThrows(char const* text)
+    {
+        writeFile(kTextPath, text);
+
+        try
+        {
+            MappedPolylineFile<Point<2> > in(kTextPath);
+            PolylineArena<Point<2> > arena;
+
+            readAllParallel(in, arena, 2);
+        }
+        catch(std::runtime_error const&)
+        {
+            return true;
+        }
+
+        return false;
+    }
+
+    bool binaryThrows(std::string const& bytes)
+    {
+        {
+            std::ofstream out(kBinaryPath, std::ios::binary);
+
+            out.write(bytes.data(), bytes.size());
+        }
+
+        try
+        {
+            BinaryPolylineFile in(kBinaryPath);
+        }
+        catch(std::runtime_error const&)
+        {
+            return true;
+        }
+
+        return false;
+    }
+
+    void testTextRoundTrip()
+    {
+        const LineVec lines = randomLines(300, 1);
+
+        writeText(lines);
+
+        MappedPolylineFile<Point<2> > mapped(kTextPath);
+        PolylineArena<Point<2> > arena;
+
+        check(mapped.getPolylineCount() == 300, "mapped polyline count");
+        mapped.readAll(arena);
+        check(sameLines(lines, arena), "writer output reads back exactly through the mapping");
+
+        std::ifstream stream(kTextPath);
+        PolylineFile<Point<2> > file(stream);
+        bool same = file.getPolylineCount() == 300;
+
+        for(int i = 0; same && i < 300; ++i)
+        {
+            const Line line = file.getNext();
+
+            same = samePoints(line.points, lines[i].points) && !(line.color != lines[i].color);
+        }
+
+        check(same, "writer output reads back exactly through the stream reader");
+    }
+
+    void testTextFormat()
+    {
+        writeFile(kTextPath, "2\n0\n-3 #f00 1 2 3 4 5 6");
+
+        MappedPolylineFile<Point<2> > in(kTextPath);
+        PolylineArena<Point<2> > arena;
+
+        in.readAll(arena);
+
+        check(arena.size() == 2 && arena.lines[0].count == 0 && !(arena.lines[0].color != Color::black()),
+              "empty polyline defaults to black");
+        check(arena.size() == 2 && arena.lines[1].count == 4 && samePoint(arena.begin(1)[3], point(1, 2)),
+              "closed polyline repeats its first point");
+        check(arena.size() == 2 && !(arena.lines[1].color != Color(0xf000, 0, 0)), "short color form");
+
+        check(mappedThrows("2\n1 1 2\n"), "missing polyline is rejected");
+        check(mappedThrows("1\n2 1 2 3\n"), "missing coordinate is rejected");
+        check(mappedThrows("1\n1 #12 1 2\n"), "bad color is rejected");
+        check(mappedThrows("1\n1 1 x\n"), "bad number is rejected");
+        check(mappedThrows("1\n1000000000 1 2\n"), "huge point count is rejected");
+        check(mappedThrows("x\n"), "bad polyline count is rejected");
+    }
+
+    std::string formatted(Color const& color)
+    {
+        char buf[kMaxColorChars];
+
+        return std::string(buf, formatColor(buf, color) - buf);
+    }
+
+    bool writeThrows(double x, double y)
+    {
+        std::ostringstream out;
+        PolylineWriter<Point<2> > writer(out, 1);
+        Line line;
+
+        line.points.push_back(point(0, 0));
+        line.points.push_back(point(x, y));
+
+        try
+        {
+            writer.write(line);
+        }
+        catch(std::runtime_error const&)
+        {
+            writer.close();
+            return out.str() == "1\n";
+        }
+
+        return false;
+    }
+
+    void testColors()
+    {
+        const Color colors[] =
+        {
+            Color(255, 0, 0), Color(0xf000, 0, 0), Color(0xff00, 0x1200, 0), Color(0xf000, 0x0f00, 0),
+            Color(1, 2, 3), Color(0xffff, 0xffff, 0xffff), Color(0x1234, 0x5678, 0x9abc)
+        };
+        const int count = sizeof(colors) / sizeof(colors[0]);
+
+        check(formatted(Color(0xf000, 0, 0)) == "#f00", "three digit form");
+        check(formatted(Color(0xff00, 0x1200, 0)) == "#ff1200", "six digit form");
+        check(formatted(Color(255, 0, 0)) == "#00ff00000000", "low digits need the long form");
+
+        bool same = true;
+
+        for(int i = 0; i < count; ++i)
+        {
+            Color color;
+
+            same = same && parseColor(formatted(colors[i]), color) && !(color != colors[i]);
+        }
+
+        check(same, "formatted colors parse back to the same color");
+
+        LineVec lines(count);
+
+        for(int i = 0; i < count; ++i)
+        {
+            lines[i].points.push_back(point(i, i));
+            lines[i].color = colors[i];
+        }
+
+        writeText(lines);
+
+        MappedPolylineFile<Point<2> > in(kTextPath);
+        PolylineArena<Point<2> > arena;
+
+        in.readAll(arena);
+        check(sameLines(lines, arena), "colors of the writer output read back exactly");
+    }
+
+    void testNonFinite()
+    {
+        check(writeThrows(NAN, 0), "NaN is rejected on write");
+        check(writeThrows(0, INFINITY), "infinity is rejected on write");
+        check(writeThrows(-INFINITY, 0), "negative infinity is rejected on write");
+        check(mappedThrows("1\n1 nan 0\n") && mappedThrows("1\n1 inf 0\n"), "the reader rejects them too");
+    }
+
+    void testBinary()
+    {
+        const LineVec lines = randomLines(200, 2);
+        BinaryPolylineWriter out(kBinaryPath, 2);
+        std::size_t total = 0;
+
+        for(LineVec::const_iterator it = lines.begin(); it != lines.end(); ++it)
+        {
+            out.write(*it);
+            total += it->points.size();
+        }
+
+        out.close();
+
+        {
+            BinaryPolylineFile in(kBinaryPath);
+            bool same = in.getPolylineCount() == 200 && in.getDimension() == 2 && in.getTotalPointCount() == total;
+
+            for(int i = 0; same && i < 200; ++i)
+            {
+                const PolylineSpan<Point<2> > span = in.get<Point<2> >(i);
+
+                same = sameLine(lines[i], span.begin(), span.end(), span.color);
+            }
+
+            check(same, "binary round-trip");
+        }
+
+        BinaryPolylineWriter floats(kBinaryPath, 2, true);
+
+        for(LineVec::const_iterator it = lines.begin(); it != lines.end(); ++it)
+        {
+            floats.write(*it);
+        }
+
+        floats.close();
+
+        std::string bytes;
+
+        {
+            BinaryPolylineFile in(kBinaryPath);
+            bool close = in.hasFloatCoordinates() && in.getPolylineCount() == 200;
+
+            for(int i = 0; close && i < 200; ++i)
+            {
+                float const* coordinates = in.getFloats(i);
+
+                close = in.getPointCount(i) == lines[i].points.size();
+
+                for(std::size_t j = 0; close && j < lines[i].points.size(); ++j)
+                {
+                    close = coordinates[2 * j] == static_cast<float>(lines[i].points[j][0]) &&
+                        coordinates[2 * j + 1] == static_cast<float>(lines[i].points[j][1]);
+                }
+            }
+
+            check(close, "float round-trip");
+
+            std::ifstream file(kBinaryPath, std::ios::binary);
+            std::ostringstream buffer;
+
+            buffer << file.rdbuf();
+            bytes = buffer.str();
+        }
+
+        check(!binaryThrows(bytes), "correct binary file is read");
+        check(binaryThrows(bytes.substr(0, bytes.size() - 8)), "truncated binary file is rejected");
+        check(binaryThrows(bytes.substr(0, 32)), "truncated binary header is rejected");
+
+        std::string corrupt = bytes;
+
+        corrupt[0] = 'X';
+        check(binaryThrows(corrupt), "bad binary magic is rejected");
+
+        // Point count of the header, larger than the coordinates
+        corrupt = bytes;
+        corrupt[32 + 7] = 0x40;
+        check(binaryThrows(corrupt), "bad binary point count is rejected");
+    }
+
+    void testIndex()
+    {
+        const LineVec lines = randomLines(300, 3);
+
+        writeText(lines);
+        buildPolylineIndex<Point<2> >(kTextPath, kIndexPath);
+
+        MappedPolylineFile<Point<2> > in(kTextPath);
+        PolylineIndex index(kIndexPath);
+        PolylineArena<Point<2> > arena;
+        std::vector<int> ids;
+
+        check(index.getPolylineCount() == 300 && index.matches(in.getFile()), "index matches its file");
+
+        // Cell (2, 3) of the grid, polylines 32, 132 and 232
+        index.query(Box<2>(point(21, 31), point(29, 39)), ids);
+
+        bool found = true;
+
+        for(int i = 32; i < 300; i += 100)
+        {
+            found = found && (lines[i].points.empty() || std::find(ids.begin(), ids.end(), i) != ids.end());
+        }
+
+        check(found, "index query finds the polylines in the area");
+
+        bool inside = true;
+
+        for(std::vector<int>::const_iterator it = ids.begin(); it != ids.end(); ++it)
+        {
+            inside = inside && *it % 100 == 32;
+        }
+
+        check(inside, "index query leaves out distant polylines");
+
+        bool same = true;
+
+        for(int i = 0; same && i < 300; ++i)
+        {
+            arena.clear();
+            in.readAt(index.getOffset(i), arena);
+
+            same = index.getPointCount(i) == lines[i].points.size() &&
+                sameLine(lines[i], arena.begin(0), arena.end(0), arena.lines[0].color);
+        }
+
+        check(same, "polylines are read at the offsets of the index");
+    }
+
+    void testParallel()
+    {
+        const LineVec lines = randomLines(1000, 4);
+
+        writeText(lines);
+        buildPolylineIndex<Point<2> >(kTextPath, kIndexPath);
+
+        PolylineIndex index(kIndexPath);
+
+        for(int threads = 1; threads <= 5; threads += 2)
+        {
+            MappedPolylineFile<Point<2> > sequential(kTextPath);
+            MappedPolylineFile<Point<2> > parallel(kTextPath);
+            MappedPolylineFile<Point<2> > indexed(kTextPath);
+            PolylineArena<Point<2> > expected;
+            PolylineArena<Point<2> > arena;
+            PolylineArena<Point<2> > indexedArena;
+
+            // Start after a few polylines read one by one
+            for(int i = 0; i < 7; ++i)
+            {
+                sequential.readNext(expected);
+                parallel.readNext(arena);
+                indexed.readNext(indexedArena);
+            }
+
+            sequential.readAll(expected);
+            readAllParallel(parallel, arena, threads);
+            readAllParallel(indexed, index, indexedArena, threads);
+
+            check(sameLines(lines, expected), "sequential read");
+            check(sameArenas(expected, arena), "parallel read matches the sequential one");
+            check(sameArenas(expected, indexedArena), "indexed parallel read matches the sequential one");
+            check(parallel.getPosition() == sequential.getPosition() &&
+                  indexed.getPosition() == sequential.getPosition(), "parallel read leaves the reader at the end");
+        }
+
+        check(parallelThrows("3\n1 1 2\n1 3 4\n"), "missing polyline is rejected by the parallel read");
+        check(parallelThrows("2\n1 1 2\n1 3 x\n"), "bad number is rejected by the parallel read");
+    }
+
+} // namespace <unnamed>
+
+int main()
+{
+    testTextRoundTrip();
+    testTextFormat();
+    testColors();
+    testNonFinite();
+    testBinary();
+    testIndex();
+    testParallel();
+
+    std::remove(kTextPath);
+    std::remove(kIndexPath);
+    std::remove(kBinaryPath);
+
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,222 @@
+/*
+ * Copyright (c) 2006 Emir UNER
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <algorithm>
+#include <iostream>
+#include <utility>
+#include <vector>
+
+#include <simge/algo/SegmentIntersections.hpp>
+
+using namespace simge::geom;
+using namespace simge::algo;
+
+namespace
+{
+    int failures = 0;
+
+    void check(bool condition, char const* what)
+    {
+        if(!condition)
+        {
+            std::cerr << "FAILED: " << what << std::endl;
+            ++failures;
+        }
+    }
+
+    typedef std::vector<Edge<2> > EdgeVec;
+    typedef std::vector<std::pair<int, int> > PairVec;
+
+    /**
+     * Same sequence on every platform, unlike rand().
+     */
+    class Random
+    {
+    public:
+        explicit Random(unsigned long long seed)
+        : state_(seed)
+        {
+        }
+
+        double next()
+        {
+            state_ = state_ * 6364136223846793005ULL + 1442695040888963407ULL;
+
+            return static_cast<double>(state_ >> 11) / 4503599627370496.0 - 1;
+        }
+
+    private:
+        unsigned long long state_;
+    };
+
+    bool isOnEdge(Edge<2> const& edge, Point<2> const& p)
+    {
+        Point<2> const& a = edge[0];
+        Point<2> const& b = edge[1];
+        const double dx = b[0] - a[0];
+        const double dy = b[1] - a[1];
+        const double lengthSquared = dx * dx + dy * dy;
+        double t = 0;
+
+        if(lengthSquared > 0)
+        {
+            t = ((p[0] - a[0]) * dx + (p[1] - a[1]) * dy) / lengthSquared;
+            t = t < 0 ? 0 : (t > 1 ? 1 : t);
+        }
+
+        return point(a[0] + t * dx, a[1] + t * dy) == p;
+    }
+
+    class PairCollector : public IntersectionListener
+    {
+    public:
+        PairCollector(EdgeVec const& edges)
+        : edges_(edges), wrongPoints(0)
+        {
+        }
+
+        void found(int first, int second, Point<2> const& at)
+        {
+            pairs.push_back(std::make_pair(first, second));
+
+            if(!(isOnEdge(edges_[first], at) && isOnEdge(edges_[second], at)))
+            {
+                ++wrongPoints;
+            }
+        }
+
+        EdgeVec const& edges_;
+        PairVec pairs;
+        int wrongPoints;
+    };
+
+    PairVec sweep(EdgeVec const& edges, int& wrongPoints)
+    {
+        PairCollector collector(edges);
+
+        findAllIntersections(edges, collector);
+        std::sort(collector.pairs.begin(), collector.pairs.end());
+        wrongPoints = collector.wrongPoints;
+
+        return collector.pairs;
+    }
+
+    PairVec allPairs(EdgeVec const& edges)
+    {
+        PairVec pairs;
+        Point<2> at;
+
+        for(std::size_t i = 0; i < edges.size(); ++i)
+        {
+            for(std::size_t j = i + 1; j < edges.size(); ++j)
+            {
+                if(intersection(edges[i], edges[j], at))
+                {
+                    pairs.push_back(std::make_pair(i, j));
+                }
+            }
+        }
+
+        return pairs;
+    }
+
+    /**
+     * Segments of random direction and length up to length in the
+     * square [-1, 1) x [-1, 1).
+     */
+    EdgeVec randomEdges(int count, double length, unsigned long long seed)
+    {
+        Random random(seed);
+        EdgeVec edges;
+
+        for(int i = 0; i < count; ++i)
+        {
+            const Point<2> p = point(random.next(), random.next());
+
+            edges.push_back(Edge<2>(p, point(p[0] + length * random.next(), p[1] + length * random.next())));
+        }
+
+        return edges;
+    }
+
+    void testRandom()
+    {
+        const double lengths[] = { 0.05, 0.3, 2 };
+
+        for(int i = 0; i < 3; ++i)
+        {
+            const EdgeVec edges = randomEdges(400, lengths[i], i + 1);
+            int wrongPoints = 0;
+            const PairVec found = sweep(edges, wrongPoints);
+            const PairVec expected = allPairs(edges);
+
+            check(!expected.empty(), "random segments intersect");
+            check(found == expected, "sweep finds the same pairs as checking all pairs");
+            check(wrongPoints == 0, "intersection points are on both segments");
+        }
+    }
+
+    void testDegenerate()
+    {
+        EdgeVec edges;
+
+        // A triangle, its edges share end points
+        edges.push_back(Edge<2>(point(0, 0), point(4, 0)));
+        edges.push_back(Edge<2>(point(4, 0), point(2, 3)));
+        edges.push_back(Edge<2>(point(2, 3), point(0, 0)));
+        // Vertical edge touching the base at its end point
+        edges.push_back(Edge<2>(point(1, 0), point(1, -2)));
+        // Overlaps the base
+        edges.push_back(Edge<2>(point(3, 0), point(6, 0)));
+        // Crosses the vertical edge and nothing else
+        edges.push_back(Edge<2>(point(0, -1), point(2, -1)));
+        // Away from everything
+        edges.push_back(Edge<2>(point(10, 10), point(11, 11)));
+        // A point on the second triangle edge
+        edges.push_back(Edge<2>(point(3, 1.5), point(3, 1.5)));
+
+        PairVec expected;
+
+        expected.push_back(std::make_pair(0, 1));
+        expected.push_back(std::make_pair(0, 2));
+        expected.push_back(std::make_pair(0, 3));
+        expected.push_back(std::make_pair(0, 4));
+        expected.push_back(std::make_pair(1, 2));
+        expected.push_back(std::make_pair(1, 4));
+        expected.push_back(std::make_pair(1, 7));
+        expected.push_back(std::make_pair(3, 5));
+
+        int wrongPoints = 0;
+
+        check(sweep(edges, wrongPoints) == expected, "touching, shared and overlapping edges are reported");
+        check(wrongPoints == 0, "degenerate intersection points are on both segments");
+    }
+
+} // namespace <unnamed>
+
+int main()
+{
+    testRandom();
+    testDegenerate();
+
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,271 @@
+/*
+ * Copyright (c) 2006 Emir UNER
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <cmath>
+#include <cstdio>
+#include <iostream>
+#include <vector>
+
+#include <simge/algo/Simplify.hpp>
+
+using namespace simge::geom;
+using namespace simge::algo;
+
+namespace
+{
+    int failures = 0;
+
+    void check(bool condition, char const* what)
+    {
+        if(!condition)
+        {
+            std::cerr << "FAILED: " << what << std::endl;
+            ++failures;
+        }
+    }
+
+    typedef std::vector<Point<2> > PointVec;
+
+    /**
+     * Same sequence on every platform, unlike rand().
+     */
+    class Random
+    {
+    public:
+        explicit Random(unsigned long long seed)
+        : state_(seed)
+        {
+        }
+
+        // Uniform in [-1, 1)
+        double next()
+        {
+            state_ = state_ * 6364136223846793005ULL + 1442695040888963407ULL;
+
+            return static_cast<double>(state_ >> 11) / 4503599627370496.0 - 1;
+        }
+
+    private:
+        unsigned long long state_;
+    };
+
+    PointVec randomWalk(int count, unsigned long long seed)
+    {
+        Random random(seed);
+        PointVec points;
+        double x = 0;
+        double y = 0;
+
+        for(int i = 0; i < count; ++i)
+        {
+            points.push_back(point(x, y));
+            x += random.next();
+            y += random.next();
+        }
+
+        return points;
+    }
+
+    double segmentDistance(Point<2> const& p, Point<2> const& a, Point<2> const& b)
+    {
+        const double dx = b[0] - a[0];
+        const double dy = b[1] - a[1];
+        const double lengthSquared = dx * dx + dy * dy;
+        double t = 0;
+
+        if(lengthSquared > 0)
+        {
+            t = ((p[0] - a[0]) * dx + (p[1] - a[1]) * dy) / lengthSquared;
+            t = t < 0 ? 0 : (t > 1 ? 1 : t);
+        }
+
+        return std::sqrt(std::pow(a[0] + t * dx - p[0], 2) + std::pow(a[1] + t * dy - p[1], 2));
+    }
+
+    /**
+     * Textbook recursive Douglas-Peucker.
+     */
+    void referenceDouglasPeucker(PointVec const& points, int first, int last, double tolerance,
+                                 std::vector<int>& kept)
+    {
+        int farthest = -1;
+        double distance = -1;
+
+        for(int i = first + 1; i < last; ++i)
+        {
+            const double d = segmentDistance(points[i], points[first], points[last]);
+
+            if(d > distance)
+            {
+                farthest = i;
+                distance = d;
+            }
+        }
+
+        if(farthest != -1 && distance >= tolerance)
+        {
+            referenceDouglasPeucker(points, first, farthest, tolerance, kept);
+            kept.push_back(farthest);
+            referenceDouglasPeucker(points, farthest, last, tolerance, kept);
+        }
+    }
+
+    /**
+     * Textbook Visvalingam-Whyatt removing the smallest triangle while it
+     * is smaller than minArea, in quadratic time.
+     */
+    std::vector<int> referenceVisvalingam(PointVec const& points, double minArea)
+    {
+        std::vector<int> kept;
+
+        for(int i = 0; i < static_cast<int>(points.size()); ++i)
+        {
+            kept.push_back(i);
+        }
+
+        for(;;)
+        {
+            int smallest = -1;
+            double area = minArea;
+
+            for(std::size_t i = 1; i + 1 < kept.size(); ++i)
+            {
+                Point<2> const& a = points[kept[i - 1]];
+                Point<2> const& b = points[kept[i]];
+                Point<2> const& c = points[kept[i + 1]];
+                const double ai = std::fabs((b[0] - a[0]) * (c[1] - a[1]) - (c[0] - a[0]) * (b[1] - a[1])) / 2;
+
+                if(ai < area)
+                {
+                    smallest = i;
+                    area = ai;
+                }
+            }
+
+            if(smallest == -1)
+            {
+                return kept;
+            }
+
+            kept.erase(kept.begin() + smallest);
+        }
+    }
+
+    bool isSubset(std::vector<int> const& small, std::vector<int> const& large)
+    {
+        std::size_t j = 0;
+
+        for(std::size_t i = 0; i < small.size(); ++i)
+        {
+            while(j < large.size() && large[j] < small[i])
+            {
+                ++j;
+            }
+
+            if(j == large.size() || large[j] != small[i])
+            {
+                return false;
+            }
+        }
+
+        return true;
+    }
+
+    void testDouglasPeuckerMatchesReference()
+    {
+        const PointVec points = randomWalk(20000, 1);
+
+        for(double tolerance = 0.5; tolerance <= 64; tolerance *= 2)
+        {
+            std::vector<int> kept;
+            std::vector<int> expected;
+
+            douglasPeucker(points, tolerance, kept);
+            expected.push_back(0);
+            referenceDouglasPeucker(points, 0, points.size() - 1, tolerance, expected);
+            expected.push_back(points.size() - 1);
+            check(kept == expected, "douglasPeucker keeps the vertexes of the recursive algorithm");
+        }
+    }
+
+    void testVisvalingamMatchesReference()
+    {
+        const PointVec points = randomWalk(1500, 2);
+
+        for(double area = 0.25; area <= 64; area *= 4)
+        {
+            std::vector<int> kept;
+
+            visvalingam(points, area, kept);
+            check(kept == referenceVisvalingam(points, area), "visvalingam keeps the vertexes of the quadratic algorithm");
+        }
+    }
+
+    /**
+     * Selects with the pyramid and the plain algorithm on a large walk and
+     * prints the kept vertex counts per tolerance in pixels, as a view at
+     * one pixel per unit would draw them.
+     */
+    void testPyramidSelect(char const* name, PointVec const& points, std::vector<double> const& importance,
+                           void (*simplify)(PointVec const&, double, std::vector<int>&), bool isArea)
+    {
+        const SimplificationPyramid pyramid(importance);
+        std::vector<int> previous;
+
+        check(pyramid.size() == static_cast<int>(points.size()), "pyramid has a vertex per point");
+
+        for(double pixels = 0.25; pixels <= 256; pixels *= 2)
+        {
+            const double threshold = isArea ? pixels * pixels : pixels;
+            std::vector<int> kept;
+            std::vector<int> expected;
+
+            pyramid.select(threshold, kept);
+            simplify(points, threshold, expected);
+
+            check(kept == expected, "pyramid selects the vertexes of the plain algorithm");
+            check(!kept.empty() && kept.front() == 0 && kept.back() == static_cast<int>(points.size()) - 1,
+                  "end points are kept");
+            check(previous.empty() || isSubset(kept, previous), "a larger tolerance only drops vertexes");
+
+            std::printf("%-13s %8.2f px %8d vertexes\n", name, pixels, static_cast<int>(kept.size()));
+            previous.swap(kept);
+        }
+    }
+}
+
+int main()
+{
+    testDouglasPeuckerMatchesReference();
+    testVisvalingamMatchesReference();
+
+    const PointVec points = randomWalk(200000, 3);
+    std::vector<double> importance;
+
+    douglasPeuckerImportance(points, importance);
+    testPyramidSelect("DouglasPeucker", points, importance, &douglasPeucker, false);
+
+    visvalingamImportance(points, importance);
+    testPyramidSelect("Visvalingam", points, importance, &visvalingam, true);
+
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,146 @@
+/*
+ * Copyright (c) 2006 Emir UNER
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <algorithm>
+#include <iostream>
+#include <utility>
+#include <vector>
+
+#include <simge/algo/Validity.hpp>
+
+using namespace simge::geom;
+using namespace simge::algo;
+
+namespace
+{
+    int failures = 0;
+
+    void check(bool condition, char const* what)
+    {
+        if(!condition)
+        {
+            std::cerr << "FAILED: " << what << std::endl;
+            ++failures;
+        }
+    }
+
+    Polygon<2> polygon(double const* coordinates, int count, PolygonType type = PolygonType::LeftIsInterior())
+    {
+        Polygon<2> result(type);
+
+        for(int i = 0; i < count; ++i)
+        {
+            result.addVertex(point(coordinates[2 * i], coordinates[2 * i + 1]));
+        }
+
+        return result;
+    }
+
+    bool hasCrossing(PolygonDefects const& defects, int first, int second)
+    {
+        return std::find(defects.crossings.begin(), defects.crossings.end(),
+                         std::make_pair(first, second)) != defects.crossings.end();
+    }
+
+    void testValid()
+    {
+        const double square[] = { 0, 0, 1, 0, 1, 1, 0, 1 };
+        const PolygonDefects defects = validatePolygon(polygon(square, 4));
+
+        check(defects.isValid() && defects.isSimple(), "counter-clockwise square is valid");
+        check(!defects.notMonotone, "square is monotone");
+
+        const double clockwise[] = { 0, 0, 0, 1, 1, 1, 1, 0 };
+
+        check(validatePolygon(polygon(clockwise, 4)).wrongOrientation,
+              "clockwise square is wrongly oriented");
+        check(validatePolygon(polygon(clockwise, 4, PolygonType::RightIsInterior())).isValid(),
+              "clockwise square is valid when right is interior");
+    }
+
+    void testCrossings()
+    {
+        const double bowTie[] = { 0, 0, 1, 1, 1, 0, 0, 1 };
+        const PolygonDefects defects = validatePolygon(polygon(bowTie, 4));
+
+        check(!defects.isSimple(), "bow-tie is not simple");
+        check(defects.crossings.size() == 1 && hasCrossing(defects, 0, 2), "bow-tie edges 0 and 2 cross");
+        check(defects.duplicates.empty(), "bow-tie has no duplicate vertexes");
+
+        // The edge from 2 to 3 goes back over the edge from 1 to 2
+        const double spike[] = { 0, 0, 2, 0, 3, 1, 2.5, 0.5, 0, 2 };
+        const PolygonDefects spiked = validatePolygon(polygon(spike, 5));
+
+        check(hasCrossing(spiked, 1, 2), "edges folding back onto each other cross");
+
+        // Neighbouring edges only share their vertex
+        const double concave[] = { 0, 0, 4, 0, 2, 1, 4, 4, 0, 4 };
+
+        check(validatePolygon(polygon(concave, 5)).crossings.empty(), "concave polygon has no crossings");
+    }
+
+    void testDuplicates()
+    {
+        const double repeated[] = { 0, 0, 1, 0, 1, 0, 1, 1, 0, 1 };
+        const PolygonDefects defects = validatePolygon(polygon(repeated, 5));
+
+        check(!defects.isSimple(), "repeated vertex is not simple");
+        check(defects.duplicates.size() == 1 && defects.duplicates[0] == 2, "repeated vertex is the later one");
+
+        // The polygon touches itself at (2, 2), between the copies the
+        // sort order has a vertex nearly equal to them
+        const double pinched[] = { 0, 0, 4, 0, 2, 2, 4, 4, 2, 2 + 1e-9, 0, 4, 2, 2 };
+        const PolygonDefects pinch = validatePolygon(polygon(pinched, 7));
+
+        check(pinch.duplicates.size() == 1 && pinch.duplicates[0] == 6, "distant equal vertexes are found");
+
+        const double near[] = { 0, 0, 1, 0, 1, 1e-9, 1, 1, 0, 1 };
+
+        check(validatePolygon(polygon(near, 5)).duplicates.empty(), "nearly equal vertexes are not duplicates");
+    }
+
+    void testMonotone()
+    {
+        // Opens to the right, vertical lines through the middle cross it four times
+        const double hook[] = { 0, 0, 4, 0, 4, 1, 1, 1, 1, 3, 4, 3, 4, 4, 0, 4 };
+        const PolygonDefects defects = validatePolygon(polygon(hook, 8));
+
+        check(defects.isValid(), "hook is valid");
+        check(defects.notMonotone && !isMonotone(polygon(hook, 8)), "hook is not monotone");
+
+        // Opens upwards, vertical lines cross it at most twice
+        const double cup[] = { 0, 0, 4, 0, 4, 4, 3, 4, 3, 1, 1, 1, 1, 4, 0, 4 };
+
+        check(isMonotone(polygon(cup, 8)), "cup is monotone");
+    }
+
+} // namespace <unnamed>
+
+int main()
+{
+    testValid();
+    testCrossings();
+    testDuplicates();
+    testMonotone();
+
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,121 @@
+/*
+ * Copyright (c) 2006 Emir UNER
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <iostream>
+#include <vector>
+
+#include <simge/geom/Polygon.hpp>
+#include <simge/geom/Weld.hpp>
+
+using namespace simge::geom;
+
+namespace
+{
+    int failures = 0;
+
+    void check(bool condition, char const* what)
+    {
+        if(!condition)
+        {
+            std::cerr << "FAILED: " << what << std::endl;
+            ++failures;
+        }
+    }
+
+    /**
+     * Exact comparison, Point's operator== has a tolerance.
+     */
+    bool samePoint(Point<2> const& lhs, Point<2> const& rhs)
+    {
+        return lhs[0] == rhs[0] && lhs[1] == rhs[1];
+    }
+
+    void testSnap()
+    {
+        check(samePoint(snap(point(0.26, -0.74), 0.5), point(0.5, -0.5)), "snap to the nearest node");
+        check(samePoint(snap(point(-0.2, 0.2), 0.5), point(0, 0)), "snap near the origin");
+        check(samePoint(snap(point(1e30, 3), 1e-10), point(1e30, 3)), "points out of range are not snapped");
+
+        check(isInGridRange(point(1e6, -1e6), 1e-6), "ordinary points are in range");
+        check(!isInGridRange(point(1e30, 0), 1e-10), "far points are out of range");
+        check(gridKey(point(0.49, -0.49), 1) == gridKey(point(-0.49, 0.49), 1), "keys of the same node");
+        check(!(gridKey(point(0.51, 0), 1) == gridKey(point(0.49, 0), 1)), "keys of neighbouring nodes");
+        check(exactKey(point(-0.0, 1)) == exactKey(point(0.0, 1)), "exact keys ignore the sign of zero");
+    }
+
+    void testWelder()
+    {
+        VertexWelder<2> welder(0.1);
+
+        check(welder.weld(point(0.01, 0.02)) == 0, "first vertex");
+        check(welder.weld(point(-0.03, 0.04)) == 0, "nearby vertex is welded");
+        check(welder.weld(point(0.1, 0)) == 1, "next node gets the next index");
+        check(welder.weld(point(0.06, 0.01)) == 1, "vertex nearer the next node");
+        check(welder.weld(point(0.01, 0.02)) == 0, "indexes are stable");
+        check(welder.getVertexes().size() == 2 && samePoint(welder.getVertexes()[0], point(0, 0)) &&
+              samePoint(welder.getVertexes()[1], point(0.1, 0)), "welded vertexes are snapped");
+
+        // Out of range points merge only with equal points
+        check(welder.weld(point(1e30, 0)) == 2, "far vertex");
+        check(welder.weld(point(1e30, 0)) == 2, "equal far vertex is welded");
+        check(welder.weld(point(1e30, 1e-300)) == 3, "different far vertex is not welded");
+        check(samePoint(welder.getVertexes()[3], point(1e30, 1e-300)), "far vertexes are kept as they are");
+
+        welder.clear();
+        check(welder.getVertexes().empty() && welder.weld(point(0.1, 0)) == 0, "clear forgets the vertexes");
+    }
+
+    void testNormalize()
+    {
+        const double coordinates[] = { 0, 0, 0.01, 0, 1, 0, 1, 1, 0.99, 1.02, 0, 1, 0.001, 0.001 };
+        const double expected[] = { 0, 0, 1, 0, 1, 1, 0, 1 };
+        Polygon<2> poly;
+
+        for(int i = 0; i < 7; ++i)
+        {
+            poly.addVertex(point(coordinates[2 * i], coordinates[2 * i + 1]));
+        }
+
+        poly.normalize(0.1);
+
+        Polygon<2> const& result = poly;
+        Polygon<2>::const_iterator it = result.begin();
+        bool same = result.size() == 4;
+
+        for(int i = 0; same && i < 4; ++i, ++it)
+        {
+            same = samePoint(*it, point(expected[2 * i], expected[2 * i + 1]));
+        }
+
+        check(same, "normalize snaps and drops the vertexes that become equal");
+    }
+
+} // namespace <unnamed>
+
+int main()
+{
+    testSnap();
+    testWelder();
+    testNormalize();
+
+    return failures == 0 ? 0 : 1;
+}